@@ -32,7 +32,7 @@
 #'     The second-best tuples are those where \code{expr} evaluates to a value in \code{layer2} and so forth.
 #'      Values occurring in none of the layers are considered worse than those in \code{layerN}.
 #'      Technically, this is realized by a prioritization chain (lexicographical order)
-#'      of \code{\link{true}} preferences.}
+#'      of \code{\link{true}} preferences, which is evaluated in one pass like a categorical attribute.}
 #' }
 #'
 #' Note that only the argument \code{expr} may contain columns from the data frame,
@@ -55,7 +55,8 @@ NULL
 #' @export
 around <- function(expr, center, df = NULL) {
   expr <- call("abs", call("-", substitute(expr), center))
-  p <- methods::new("lowpref", as.lazy(expr, parent.frame()))
+  # Distance preference, evaluated on the raw values of expr
+  p <- methods::new("distpref", as.lazy(expr, parent.frame()))
   return(assoc.composed.df(p, compose.df(df, substitute(df))))
 }
 
@@ -65,7 +66,7 @@ around <- function(expr, center, df = NULL) {
 between <- function(expr, left, right, df = NULL) {
   expr <- substitute(expr)
   between_expr <- call("pmax", call("-", left, expr), 0, call("-", expr, right))
-  p <- methods::new("lowpref", as.lazy(between_expr, parent.frame()))
+  p <- methods::new("distpref", as.lazy(between_expr, parent.frame()))
   return(assoc.composed.df(p, compose.df(df, substitute(df))))
 }
 
@@ -90,5 +91,9 @@ layered <- function(expr, ..., df = NULL) {
     p <- methods::new("truepref", as.lazy(tmp_call, par_frame))
     return(assoc.composed.df(p, composed_df))
   })
-  return(Reduce("&", layers))
+  # Prior chain of the layers (already evaluated), evaluated as categorical preference
+  p <- Reduce("&", layers)
+  res <- methods::new("layeredpref", p@p1, p@p2)
+  res@df_src <- p@df_src
+  return(res)
 }
@@ -0,0 +1,66 @@
+#' Dynamic Skyline
+#'
+#' Calculates the dynamic Skylines of many query points on the same data set, i.e., for each query point
+#' the maxima of the Pareto preference of \code{around(attribute, value)} over all attributes of the query point.
+#'
+#' @param x A data frame or an index created by \code{psel.dynamic.index}.
+#' @param queries A data frame or a matrix with column names, where each row is a query point.
+#'                The columns are numeric attributes of the data set (or all attributes of the index, in the same order).
+#' @param df A data frame or a data frame extension (e.g. a tibble).
+#' @param vars Names of the numeric attributes of \code{df} for the index.
+#'
+#' @details
+#' The dynamic Skyline of a query point \code{q = (q1, q2)} on the attributes \code{a1, a2} is
+#' \code{psel.indices(df, around(a1, q1) * around(a2, q2))}.
+#' The index stores the raw values of the attributes once (the distances are calculated in the comparisons)
+#' and the classes of identical tuples, which are evaluated only once for each query point.
+#' Hence it can be reused for many batches of query points. The query points are evaluated in parallel
+#' if the parallel computation is activated (see \code{\link{psel}}).
+#'
+#' Note that \code{around} and \code{between} are evaluated on the raw values in all preference selections.
+#'
+#' @return A list with one vector of row indices (ascending) for each query point.
+#'         \code{psel.dynamic.index} returns an index object.
+#'
+#' @seealso See \code{\link{base_pref_macros}} for \code{around}.
+#'
+#' @export
+#'
+#' @examples
+#'
+#' # Cars near to 20 mpg and 100 hp, and near to 30 mpg and 60 hp
+#' idx <- psel.dynamic.index(mtcars, c("mpg", "hp"))
+#' psel.dynamic(idx, data.frame(mpg = c(20, 30), hp = c(100, 60)))
+#'
+psel.dynamic <- function(x, queries) {
+  if (is.matrix(queries)) queries <- as.data.frame(queries)
+  if (!is.data.frame(queries) || ncol(queries) == 0) stop.syscall("Parameter queries must be a data frame or a matrix with at least one column.")
+  if (!all(vapply(queries, is.numeric, TRUE))) stop.syscall("All columns of the query points must be numeric.")
+
+  if (is.data.frame(x)) {
+    x <- psel.dynamic.index(x, names(queries))
+  } else if (!inherits(x, "psel_dynamic_index")) {
+    stop.syscall("First argument has to be a data frame or an index created by psel.dynamic.index.")
+  } else if (!identical(names(queries), x$vars)) {
+    stop.syscall(paste0("The query points must have the columns ", paste(x$vars, collapse = ", "), "."))
+  }
+
+  alpha <- getOption("rPref.scalagon.alpha", default = 1)
+  res <- dynamic_skyline_impl(x$handle, as.matrix(queries), alpha, get_num_threads())
+
+  # All C indices start at 0, and all R indices start at 1
+  return(lapply(res, function(ind) ind + 1))
+}
+
+#' @rdname psel.dynamic
+#' @export
+psel.dynamic.index <- function(df, vars) {
+  if (!is.data.frame(df)) stop.syscall("First argument has to be a data frame or a data frame extension.")
+  if (!is.character(vars) || length(vars) == 0 || !all(vars %in% names(df))) {
+    stop.syscall("Parameter vars must contain names of attributes of the data frame.")
+  }
+  raw <- as.data.frame(lapply(vars, function(v) df[[v]]))
+  if (!all(vapply(raw, is.numeric, TRUE))) stop.syscall("All attributes of the index must be numeric.")
+
+  return(structure(list(handle = dynamic_index_impl(raw), vars = vars), class = "psel_dynamic_index"))
+}
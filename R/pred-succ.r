@@ -30,7 +30,9 @@
 #'
 #' does the initialization of the preference \code{low(mpg)} on the data set \code{mtcars}.
 #'
-#' The \code{init_pred_succ} function calculates the Better-Than-Relation on \code{df} w.r.t. \code{p}.
+#' The \code{init_pred_succ} function evaluates \code{p} on \code{df} and stores the scores in the preference object.
+#' The Hasse diagram is not calculated in advance: the direct predecessors/successors are calculated on demand
+#' only for the given tuples, and cached for subsequent calls.
 #' Afterwards the predecessor and successor functions, as subsequently described, can be called.
 #' The value of \code{v} is a numeric vector within \code{1:nrow(df)}
 #' and characterizes a subset of tuples in \code{df}.
@@ -54,6 +56,9 @@
 #'
 #' \code{f(p, c(x, y), intersect = TRUE) == intersect(f(p, x), f(p, y))}
 #'
+#' The functions \code{all_pred} and \code{all_succ} compare all tuples of \code{df} with all tuples of \code{v} in one pass,
+#' which runs in parallel if parallel computation is activated (see \code{\link{psel}}).
+#'
 #'
 #' @examples
 #'
@@ -140,76 +145,51 @@ init_pred_succ_internal <- function(p, df, df_call) {
   p <- res$p
   # Cached scorevals
   p@scorevals <- res$scores
-  serialized <- pserialize(p)
-  # Get Hasse Matrix from C++ function, add 1 for R indices (starting at 1)
-  p@hasse_mtx <- t(get_hasse_impl(p@scorevals, serialized)) + 1
+  # Cache for direct predecessors/successors, which are calculated on demand
+  p@hasse_cache <- new.env(parent = emptyenv())
+  p@hasse_cache$ptr <- get_hasse_cache_impl(p@scorevals, pserialize(p))
   p@cache_available <- TRUE
 
   # returns modified preference
   return(p)
 }
 
-# Hasse diagram successors/predecessors
+# Hasse diagram successors/predecessors (already sorted), calculated in C++ only for the given indices
 h_predsucc <- function(p, inds, do_intersect, succ) {
   pref.df.check(p)
   check_cache(p)
 
-  # Select indices predecessors/successors
-  if (succ) {
-    l_index <- 1
-    r_index <- 2
-  } else {
-    l_index <- 2
-    r_index <- 1
+  if (length(inds) == 0) {
+    return(numeric(0))
   }
 
-  # Selection aggregation method, if inds is a vector (and not a single value)
-  if (do_intersect) {
-    agg <- intersect
-  } else {
-    agg <- union
-  }
+  # C indices start at 0, R indices start at 1
+  res <- get_hasse_predsucc_impl(hasse_cache_ptr(p), as.numeric(inds) - 1, do_intersect, succ)
+  return(res + 1)
+}
 
-  # Do the calculation
-  if (length(inds) == 0) {
-    return(numeric(0))
-  } else if (length(inds) == 1) {
-    return(p@hasse_mtx[p@hasse_mtx[, l_index] == inds, r_index])
-  } else {
-    res_inds <- lapply(inds, function(x) p@hasse_mtx[p@hasse_mtx[, l_index] == x, r_index])
-    return(sort(Reduce(agg, res_inds[-1], res_inds[[1]])))
+# External pointer to the cache of direct predecessors/successors. A serialized pointer is restored as NULL pointer,
+# then the cache is rebuilt from the score values (and kept in the environment shared by all copies of p)
+hasse_cache_ptr <- function(p) {
+  if (identical(p@hasse_cache$ptr, new("externalptr"))) {
+    p@hasse_cache$ptr <- get_hasse_cache_impl(p@scorevals, pserialize(p))
   }
+  return(p@hasse_cache$ptr)
 }
 
-# All succesors/predecessors (sorting not necessary because of "which")
+# All succesors/predecessors (already sorted), calculated in C++ (in parallel if activated)
 all_predsucc <- function(p, inds, do_intersect, succ) {
   pref.df.check(p)
   check_cache(p)
   # does not need hasse diagram, but needs p@scorevals
 
-  # Select indices predecessors/successors
-  if (succ) {
-    cmpfun <- function(x, y) cmp(p, x, y, p@scorevals)
-  } else {
-    cmpfun <- function(x, y) cmp(p, y, x, p@scorevals)
-  }
-
-  # Selection aggregation method, if inds is a vector (and not a single value)
-  if (do_intersect) {
-    agg <- pmin
-  } # min is logically equivalent to intersection
-  else {
-    agg <- pmax
-  } # max is logically equivalent to union
-
-  all_inds <- 1:nrow(p@scorevals)
   if (length(inds) == 0) {
     return(numeric(0))
-  } else if (length(inds) == 1) {
-    return(which(cmpfun(inds, all_inds)))
-  } else {
-    return(which(as.logical(do.call(agg, lapply(inds, function(x) cmpfun(x, all_inds))))))
   }
+
+  # C indices start at 0, R indices start at 1
+  res <- get_predsucc_impl(p@scorevals, pserialize(p), as.numeric(inds) - 1, do_intersect, succ, get_num_threads())
+  return(res + 1)
 }
 
 check_cache <- function(p) {
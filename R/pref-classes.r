@@ -11,7 +11,9 @@ preference <- setClass("preference",
     score_id = "numeric",
     # These are used by init_pred_succ in pred-succ.r
     cache_available = "logical",
-    hasse_mtx = "matrix",
+    # environment with the external pointer to the C++ cache of direct predecessors/successors
+    # (the pointer is rebuilt from scorevals if it is not available, e.g. after saveRDS/readRDS)
+    hasse_cache = "ANY",
     scorevals = "data.frame"
   ),
   prototype = list(
@@ -29,7 +31,7 @@ setMethod("show", signature(object = "preference"),
     if (length(object@df_src) > 0)
       cat('  * associated data source: ', object@df_src$info_str, '\n', sep = "")
     if (object@cache_available)
-      cat('  * Hasse matrix for predecessors/successors available')
+      cat('  * Cache for predecessors/successors available')
   }  
 )
 
@@ -454,161 +456,230 @@ setMethod("cmp", signature(object = "intersectionpref"),
 # Prioritization preferences
 # --------------------------
 
-# double has 52 bits significand, thus the largest double number d which surely fulfills "d \neq d+1" is 2^52
-MAX_CHAIN_LENGTH <- 52 
-
+# Prioritization chains of (possibly reversed) base/layered preferences like P1 & P2 & ... & Pn
+# are evaluated in C++ as the lexicographic order of P1, ..., Pn (see lexpref)
 
 priorpref <- setClass("priorpref",
-  slots = c(
-    chain_size = "numeric",
-    prior_chain = "logical",
-    prior_score_id = "numeric"
-  ),
-  prototype = list(op = "&",
-                   chain_size = numeric(0),
-                   prior_chain = FALSE,
-                   prior_score_id = numeric(0)),
+  prototype = list(op = "&"),
   contains = "complexpref"
 )
 
-# not generic, prior-specific. calculate recursively the length of a prior chain
-# returning NULL means, that the given preference is not a prior chain
-get_prior_length <- function(object) {
-  # Calculate sum 
-  len <- 0
-  for (p in c('p1', 'p2')) {
-    if (is.priorpref(methods::slot(object, p))) {
-      res <- get_prior_length(methods::slot(object, p))
-      if (is.null(res)) return(NULL)
-      methods::slot(object, p) <- res$p
-      len <- len + res$len
-    } else if (is.truepref(methods::slot(object, p))) {
-      len <- len + 1
-    } else {
-      return(NULL)
-    }
-    
-    # Store chain_size for get_scores(..., get_subtree = TRUE)
-    object@chain_size <- len
-  }
-  # has to return p as this was modified
-  return(list(p = object, len = len))
+# Not generic, prior-specific. Returns the leaves (p) of a prior chain of (possibly reversed)
+# base/layered preferences and their "reversed" flags, in the order of the score columns.
+# Returning NULL means, that the given preference is not such a prior chain
+get_prior_leaves <- function(object, reversed = FALSE) {
+  # Leaves have exactly one score column
+  if (is.base_pref(object) || is.categorical.layeredpref(object)) return(list(p = list(object), reversed = reversed))
+  # The reverse of a prior chain is the prior chain of the reversed preferences
+  if (is.reversepref(object)) return(get_prior_leaves(object@p, !reversed))
+  if (!is.priorpref(object)) return(NULL)
+  
+  res1 <- get_prior_leaves(object@p1, reversed)
+  if (is.null(res1)) return(NULL)
+  res2 <- get_prior_leaves(object@p2, reversed)
+  if (is.null(res2)) return(NULL)
+  return(list(p = c(res1$p, res2$p), reversed = c(res1$reversed, res2$reversed)))
 }
-    
-# Calculate prior-chain score, not generic, prior-specific
-# does not modify the object, hence does not return it!
-get_priorchain_scores <- function(object, next_id, prior_length, df) {
-  scores <- 0
-  for (p in c('p1', 'p2')) {
-    if (is.priorpref(methods::slot(object, p))) {
-      res <- get_priorchain_scores(methods::slot(object, p), next_id, prior_length, df)
-      scores <- scores + res$scores
-      next_id <- res$next_id
-    } else if (is.truepref(methods::slot(object, p))) { # p is not prioritization, use generic!
-      res <- get_scores(methods::slot(object, p), 1, df)
-      scores <- scores + 2 ^ (prior_length - next_id) * res$scores
-      # Increase next_id after true preference
-      next_id <- next_id + 1
-    }
+
+setMethod("pserialize", signature(object = "priorpref"),
+  function(object) {
+    res <- get_prior_leaves(object)
+    if (!is.null(res)) # Prior chain is like a numerical base preference on a lexicographic key
+      return(list(kind = 'l', reversed = res$reversed, p = lapply(res$p, pserialize)))
+    else
+      return(methods::callNextMethod(object))
   }
+)
+
+setMethod("cmp", signature(object = "priorpref"),
+  function(object, i, j, score_df) { # TRUE if i is better than j
+    return( cmp(object@p1, i, j, score_df) | 
+           (eq( object@p1, i, j, score_df) & cmp(object@p2, i, j, score_df)) ) 
+  }
+)
   
-  return(list(next_id = next_id, scores = scores))
+is.priorpref <- function(x) inherits(x, "priorpref")
+
+
+# Layered preferences
+# -------------------
+
+# A layered preference is a prior chain of true preferences "expr %in% layer" (see base_pref_macros).
+# It is evaluated as categorical preference in C++ (see catpref): The score column contains codes
+# of the values of expr (0 for values in no layer), and layer_lookup[code + 1] is the level of a code.
+
+layeredpref <- setClass("layeredpref",
+  slots = c(layer_lookup = "numeric"),
+  prototype = list(layer_lookup = numeric(0)),
+  contains = "priorpref"
+)
+
+# Not generic, layered-specific. All leaves of a left-deep prior chain
+get_layer_leaves <- function(object) {
+  if (is.priorpref(object)) return(c(get_layer_leaves(object@p1), get_layer_leaves(object@p2)))
+  return(list(object))
 }
 
-setMethod("get_scores", signature(object = "priorpref"),
+setMethod("get_scores", signature(object = "layeredpref"),
   function(object, next_id, df) {
-    # call specific function for prior-pref
-    return(get_scores_prior(object, next_id, df))
-  }
-)
+    object@layer_lookup <- numeric(0)
     
-# Get scorevals, specially consider prior-chains. Called *before* serialize! Not generic, prior-specific
-get_scores_prior <- function(object, next_id, df, get_subtree = FALSE) {
-  
-  # By default false
-  object@prior_chain = FALSE
-  
-  if (get_subtree) { # It's a prior-chain, but perhaps to large
+    # Check if all leaves have the form "expr %in% layer" with the same expr
+    leaves <- get_layer_leaves(object)
+    if (!all(vapply(leaves, is.truepref, TRUE))) return(methods::callNextMethod(object, next_id, df))
+    exprs <- lapply(leaves, function(p) p@lazy_expr$expr)
+    is_layer <- function(e) is.call(e) && identical(e[[1]], as.name("%in%")) && identical(e[[2]], exprs[[1]][[2]])
+    # Otherwise (e.g., if the leaves were modified) evaluate it like a usual prior chain
+    if (!all(vapply(exprs, is_layer, TRUE))) return(methods::callNextMethod(object, next_id, df))
     
-    if (object@chain_size <= MAX_CHAIN_LENGTH) { # subtree which is sufficiently small
-      # Set prior-chain (pseudo score preference)
-      object@prior_chain = TRUE
-      object@prior_score_id = next_id
-      res <- get_priorchain_scores(object, 1, object@chain_size, df) # does not return pref!
-      return(list(p = object, next_id = next_id + 1, scores = res$scores))
-    } # -> else: see block "** All else-paths"
-  
-  } else {
-  
-    # ** Prior chains
-    res_prior <- get_prior_length(object)
-    # Check if len > 1 (a real chain) 
-    if (!is.null(res_prior) && (res_prior$len > 1)) {
-      prior_len <- res_prior$len
-      object@chain_size <- res_prior$p@chain_size
-      # check if maxval is suffcient small to get distinctive score vals (double precision!)
-      if (prior_len <= MAX_CHAIN_LENGTH) { 
-        # Set prior-chain (pseudo score preference)
-        object@prior_chain = TRUE
-        object@prior_score_id = next_id
-        res <- get_priorchain_scores(object, 1, prior_len, df) # does not return pref!
-        return(list(p = object, next_id = next_id + 1, scores = res$scores))
-      } else {
-        # Limit reached - stop the recursive search for chains
-        
-        # Give a warning for all unbalanced trees
-        if (is.priorpref(object@p1) && object@p1$chain_size > MAX_CHAIN_LENGTH && is.truepref(object@p2) ||
-            is.priorpref(object@p2) && object@p2$chain_size > MAX_CHAIN_LENGTH && is.truepref(object@p1))
-          warning(paste0("Prioritization chain of true-preferences exceeded maximal size (", MAX_CHAIN_LENGTH, ") ",
-                         "and the operator tree is unbalanced. ",
-                          "This is a performance issue. It is recommended to build chains like ",
-                          "(P1 & ... & P", MAX_CHAIN_LENGTH, ") & ... & (P1 & ... & P", MAX_CHAIN_LENGTH, ") ",
-                          "for better performance of the preference evaluation."))
-        
-        # Change to search with known chain_sizes and use flag get_subtree = TRUE
-        res <- get_scores_prior(object, next_id, df, get_subtree = TRUE)
-        return(list(p = res$object, next_id = res$next_id, scores = res$scores))
-      }
+    # Evaluate expr only once (like the score of a base preference)
+    frm <- new.env(parent = leaves[[1]]@lazy_expr$env)
+    assign("df__", df, pos = frm)
+    vals <- eval(exprs[[1]][[2]], df, frm)
+    layers <- lapply(exprs, function(e) eval(e[[3]], df, frm))
+    if (length(vals) == 1) vals <- rep(vals, nrow(df))
+    if (length(vals) != nrow(df))
+      stop(paste0("Evaluation of layered preference ", as.character(object), " does not have the same length as the data frame!"))
+    
+    # Codes of the values: factor codes (0 for NA) or positions in the layer values (0 for none)
+    if (is.factor(vals)) {
+      keys <- levels(vals)
+      scores <- as.integer(vals)
+      scores[is.na(scores)] <- 0
+      na_member <- vapply(layers, function(l) NA %in% l, TRUE)
+    } else {
+      keys <- unique(unlist(layers))
+      scores <- match(vals, keys, nomatch = 0)
+      na_member <- rep(FALSE, length(layers))
     }
+    
+    # Layer memberships for code 0, 1, 2, ...
+    member <- rbind(na_member, matrix(vapply(layers, function(l) keys %in% l, logical(length(keys))), ncol = length(layers)))
+    
+    # Level is the lexicographic order of the true preferences (a value may occur in several layers)
+    key_str <- apply(1 * !member, 1, paste, collapse = "")
+    object@layer_lookup <- match(key_str, sort(unique(key_str), method = "radix")) - 1
+    
+    object@score_id <- next_id
+    return(list(p = object, next_id = next_id + 1, scores = as.data.frame(as.numeric(scores))))
   }
-  
-  # ** All else-paths: Handle like usual complex preference, but propagate get_subtree
-  res1 <- if (is.priorpref(object@p1)) get_scores_prior(object@p1, next_id,      df, get_subtree) else get_scores(object@p1, next_id,      df)
-  res2 <- if (is.priorpref(object@p2)) get_scores_prior(object@p2, res1$next_id, df, get_subtree) else get_scores(object@p2, res1$next_id, df)
-  object@p1 <- res1$p
-  object@p2 <- res2$p
-  return(list(p = object, next_id = res2$next_id, scores = cbind(res1$scores, res2$scores)))
+)
+
+setMethod("pserialize", signature(object = "layeredpref"),
+  function(object) {
+    if (is.categorical.layeredpref(object))
+      return(list(kind = 'c', lookup = object@layer_lookup))
+    else
+      return(methods::callNextMethod(object))
+  }
+)
+
+setMethod("cmp", signature(object = "layeredpref"),
+  function(object, i, j, score_df) { # TRUE if i is better than j
+    if (!is.categorical.layeredpref(object)) return(methods::callNextMethod(object, i, j, score_df))
+    lookup <- object@layer_lookup
+    return(lookup[score_df[i, object@score_id] + 1] < lookup[score_df[j, object@score_id] + 1])
+  }
+)
+
+setMethod("eq", signature(object = "layeredpref"),
+  function(object, i, j, score_df) { # TRUE if i is equal to j
+    if (!is.categorical.layeredpref(object)) return(methods::callNextMethod(object, i, j, score_df))
+    lookup <- object@layer_lookup
+    return(lookup[score_df[i, object@score_id] + 1] == lookup[score_df[j, object@score_id] + 1])
+  }
+)
+
+is.layeredpref <- function(x) inherits(x, "layeredpref")
+
+# Layered preference evaluated as categorical preference (i.e., after get_scores)
+is.categorical.layeredpref <- function(x) is.layeredpref(x) && length(x@layer_lookup) > 0
+
+
+# Distance preferences
+# --------------------
+
+# around(expr, center) and between(expr, left, right) are low preferences on abs(expr - center)
+# and pmax(left - expr, 0, expr - right), see base_pref_macros. They are evaluated as distance preference in C++
+# (see distpref): The score column contains the raw values of expr, and the distance to the interval
+# [dist_left, dist_right] is calculated in the comparisons.
+
+distpref <- setClass("distpref",
+  slots = c(dist_left = "numeric", dist_right = "numeric"),
+  prototype = list(dist_left = numeric(0), dist_right = numeric(0)),
+  contains = "lowpref"
+)
+
+# Not generic, distance-specific. Inner expression and interval, NULL if the expression was modified
+get_dist_parts <- function(object) {
+  e <- object@lazy_expr$expr
+  is_const <- function(x) is.numeric(x) && length(x) == 1 && !is.na(x)
+  is_minus <- function(x) is.call(x) && identical(x[[1]], as.name("-")) && length(x) == 3
+  if (is.call(e) && identical(e[[1]], as.name("abs")) && length(e) == 2 && is_minus(e[[2]]) && is_const(e[[2]][[3]])) {
+    return(list(expr = e[[2]][[2]], left = e[[2]][[3]], right = e[[2]][[3]]))
+  }
+  if (is.call(e) && identical(e[[1]], as.name("pmax")) && length(e) == 4 && is_minus(e[[2]]) && is_minus(e[[4]]) &&
+      identical(e[[3]], 0) && is_const(e[[2]][[2]]) && is_const(e[[4]][[3]]) && identical(e[[2]][[3]], e[[4]][[2]])) {
+    return(list(expr = e[[2]][[3]], left = e[[2]][[2]], right = e[[4]][[3]]))
+  }
+  return(NULL)
 }
 
-setMethod("pserialize", signature(object = "priorpref"),
+setMethod("get_scores", signature(object = "distpref"),
+  function(object, next_id, df) {
+    object@dist_left <- numeric(0)
+    object@dist_right <- numeric(0)
+    
+    # Otherwise (e.g., if the expression was modified) evaluate it like a usual low preference
+    parts <- get_dist_parts(object)
+    if (is.null(parts)) return(methods::callNextMethod(object, next_id, df))
+    
+    # Raw values of expr (like the score of a base preference)
+    frm <- new.env(parent = object@lazy_expr$env)
+    assign("df__", df, pos = frm)
+    vals <- eval(parts$expr, df, frm)
+    if (!is.numeric(vals)) stop("For the low preference ", as.character(object), " the expression must be numeric!")
+    if (length(vals) == 1) vals <- rep(vals, nrow(df))
+    if (length(vals) != nrow(df))
+      stop(paste0("Evaluation of base preference ", as.character(object), " does not have the same length as the data frame!"))
+    
+    object@dist_left <- parts$left
+    object@dist_right <- parts$right
+    object@score_id <- next_id
+    return(list(p = object, next_id = next_id + 1, scores = as.data.frame(as.numeric(vals))))
+  }
+)
+
+setMethod("pserialize", signature(object = "distpref"),
   function(object) {
-    if (object@prior_chain)  # Prior chain is like a numerical base preference
-      return(list(kind = 's'))
+    if (is.raw.distpref(object))
+      return(list(kind = 'd', left = object@dist_left, right = object@dist_right))
     else
       return(methods::callNextMethod(object))
   }
 )
 
-setMethod("cmp", signature(object = "priorpref"),
+# Distances of raw values (same arithmetic as the expression of around/between)
+dist_values <- function(object, vals) pmax(object@dist_left - vals, 0, vals - object@dist_right)
+
+setMethod("cmp", signature(object = "distpref"),
   function(object, i, j, score_df) { # TRUE if i is better than j
-    if (object@prior_chain) # Prior-Chain => Score Pref
-          return(score_df[i, object@prior_score_id] < score_df[j, object@prior_score_id])
-        else # Usual composition function for prior-preference
-          return( cmp(object@p1, i, j, score_df) | 
-                 (eq( object@p1, i, j, score_df) & cmp(object@p2, i, j, score_df)) ) 
+    if (!is.raw.distpref(object)) return(methods::callNextMethod(object, i, j, score_df))
+    return(dist_values(object, score_df[i, object@score_id]) < dist_values(object, score_df[j, object@score_id]))
   }
 )
 
-setMethod("eq", signature(object = "priorpref"),
+setMethod("eq", signature(object = "distpref"),
   function(object, i, j, score_df) { # TRUE if i is equal to j
-      if (object@prior_chain) # Prior-Chain => Score Pref
-        return(score_df[i, object@prior_score_id] == score_df[j, object@prior_score_id])
-      else
-        return(methods::callNextMethod(object, i, j, score_df))
+    if (!is.raw.distpref(object)) return(methods::callNextMethod(object, i, j, score_df))
+    return(dist_values(object, score_df[i, object@score_id]) == dist_values(object, score_df[j, object@score_id]))
   }
 )
-  
-is.priorpref <- function(x) inherits(x, "priorpref")
+
+is.distpref <- function(x) inherits(x, "distpref")
+
+# Distance preference evaluated on raw values (i.e., after get_scores)
+is.raw.distpref <- function(x) is.distpref(x) && length(x@dist_left) > 0
 
 # Non-abstract preference?
 is.actual.preference <- function(x) (is.base_pref(x) || is.complex_pref(x) || is.empty_pref(x))
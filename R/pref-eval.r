@@ -27,6 +27,12 @@
 #'      Otherwise, and for \code{psel.indices} in all cases, this option is \code{FALSE} by default.}
 #'    \item{\code{show_index}}{Logical value. If \code{TRUE}, a column \code{.index} is added to the result.
 #'      Not applicable for \code{psel.indices}.}
+#'    \item{\code{epsilon}}{Non-negative numeric value(s). If given, an approximate Skyline (epsilon-Skyline) is returned,
+#'      see below. One value for all base preferences or one value for each base preference of the Pareto composition.}
+#'    \item{\code{epsilon_relative}}{Logical value. If \code{TRUE}, \code{epsilon} is a relative tolerance (e.g. 0.05 for 5 percent),
+#'      otherwise (the default) an absolute one.}
+#'    \item{\code{representative}}{Integer. A \code{representative} value of k returns k maxima which are spread over the Skyline,
+#'      see below.}
 #' }
 #'
 #' @details
@@ -137,6 +143,74 @@
 #'
 #' \code{options(rPref.parallel.threads = 4)}
 #'
+#' The buffers of the algorithms grow on demand and are reused by each thread.
+#' With the option \code{rPref.buffer.retention} the maximum size (in MB) of the buffers kept by each thread between two evaluations
+#' can be specified, larger buffers are released. The default is 1, use \code{Inf} to keep all buffers.
+#' This is only a limit for the retained buffers, not for the memory used during an evaluation.
+#'
+#' @section Duplicates:
+#'
+#' If the data set contains many tuples with identical values w.r.t. the preference,
+#' it may be faster to evaluate only one representative per class of equivalent tuples.
+#' This is activated by
+#'
+#' \code{options(rPref.dedup = TRUE)}
+#'
+#' The result, including the levels for top-k queries, is the same as without this option
+#' (up to the choice between tuples of the same level for a \code{top} selection).
+#' For grouped data sets this option has no effect.
+#'
+#' @section Small Domains:
+#'
+#' If all attributes of a Skyline preference (Pareto or intersection of base preferences) have only a few distinct values
+#' (at most 256 per attribute, no \code{NA} values), the bitmap Skyline algorithm can be used by setting
+#'
+#' \code{options(rPref.bitmap = TRUE)}
+#'
+#' It decides the dominance for all tuples with bitwise operations on precalculated bitmaps,
+#' which is independent of the order of the tuples and runs in parallel if parallel computation is activated.
+#' The memory for the bitmaps is about the number of tuples times the sum of the numbers of distinct values (in bits),
+#' if this exceeds 256 MB or the preference is not suited, the usual algorithms are used.
+#'
+#' @section Approximate Skyline:
+#'
+#' For large Skylines, a much smaller approximation is returned by the parameter \code{epsilon},
+#' e.g., \code{psel(df, low(a) * low(b), epsilon = 0.5)}.
+#' Each base preference is divided into intervals of the width \code{epsilon} (or intervals of the factor
+#' \code{1 + epsilon} for \code{epsilon_relative = TRUE}), such that the tuples are grouped into boxes.
+#' The result contains one tuple for each box which is not dominated by another box.
+#' Every tuple of the data set is approximately dominated by a tuple of the result, i.e.,
+#' the result tuple is worse by at most \code{epsilon} (or by a factor of at most \code{1 + epsilon})
+#' in each base preference.
+#' The boxes are evaluated like a usual Skyline on the (much smaller) domains of the box numbers.
+#'
+#' The preference must be a Pareto composition of base preferences (possibly reversed) and
+#' top-k, grouped or asynchronous preference selections are not supported.
+#' For \code{epsilon = 0} the result is the Skyline with only one tuple for equivalent maxima.
+#'
+#' @section Representative Skyline:
+#'
+#' In contrast to \code{top = k}, which returns an arbitrary (often clustered) part of a large Skyline,
+#' \code{representative = k} returns k maxima which are spread over the Skyline, e.g.,
+#' \code{psel(df, low(a) * low(b), representative = 10)}.
+#' The maxima are chosen greedily: The first one is the tuple farthest from the mean of the Skyline,
+#' each next one is the tuple farthest from all chosen tuples (Euclidean distance on the values of the base preferences,
+#' each normalized to the range of the Skyline). This is a 2-approximation of the k-center problem,
+#' i.e., the maximal distance of a maximum to its nearest representative is at most twice the optimum.
+#' The tuples are stored in a grid over the score values, such that only a few grid cells are updated for each chosen tuple.
+#'
+#' The representatives are returned in the order of their selection, i.e., the first j of them are also representative.
+#' This can be combined with \code{epsilon}, but not with top-k, grouped or asynchronous preference selections.
+#'
+#' @section Result Cache:
+#'
+#' The results of identical non-grouped preference selections on unchanged data can be cached in the R session
+#' by setting the maximal number of cached results, e.g.,
+#'
+#' \code{options(rPref.cache.size = 20)}
+#'
+#' See \code{\link{psel.cache}} for details and statistics.
+#'
 #' @seealso See \code{\link{complex_pref}} on how to construct a Skyline preference.
 #'
 #'
@@ -170,8 +244,16 @@
 psel <- function(df, pref, ...) {
   df.pref.check(df, pref)
 
-  vars <- list(...)
+  sel <- psel.vars(list(...))
+
+  # Call psel.indices with all parameters from ...
+  tmp_res <- psel.indices(df, pref, .dots = sel$vars)
+
+  return(psel.rows(df, tmp_res, sel$show_level, sel$show_index))
+}
 
+# Prepare the parameters from '...' in psel for psel.indices
+psel.vars <- function(vars) {
   # Check if top-k query
   is_top <- any(names(vars) %in% c("top", "at_least", "top_level"))
 
@@ -185,9 +267,11 @@ psel <- function(df, pref, ...) {
   # Remove show_indices from vars, not needed in psel.indices
   vars <- vars[!names(vars) %in% c("show_index")]
 
-  # Call psel.indices with all parameters from ...
-  tmp_res <- psel.indices(df, pref, .dots = vars)
+  return(list(vars = vars, show_level = show_level, show_index = show_index))
+}
 
+# Select the rows of the result of psel.indices
+psel.rows <- function(df, tmp_res, show_level, show_index) {
   # Extract indices
   if (!show_level) {
     indices <- tmp_res
@@ -251,7 +335,8 @@ psel.indices <- function(df, pref, ...) {
 
   # ** Check for additional (wrong) arguments
 
-  unused_names <- setdiff(names(vars), c("top", "at_least", "top_level", "and_connected", "show_level", ".dots", ""))
+  unused_names <- setdiff(names(vars), c("top", "at_least", "top_level", "and_connected", "show_level", "epsilon", "epsilon_relative",
+                                        "representative", ".dots", ".async", ""))
 
   if (!is.null(unused_names) && length(unused_names) > 0) {
     warning(paste0("The following arguments passed to psel are no preference selection parameters and will be ignored: ", paste(unused_names, collapse = ", ")))
@@ -283,7 +368,6 @@ psel.indices <- function(df, pref, ...) {
   # ** Calculate score/serial pref
 
   # Precalculate score values for given preference, get_scores must be called before serialize!
-  # We need the correct priorchains for serializing!
   res <- get_scores(pref, 1, df)
   scores <- res$scores
   pref_serial <- pserialize(res$p)
@@ -293,13 +377,76 @@ psel.indices <- function(df, pref, ...) {
   # Get alpha value, default is 1
   alpha <- getOption("rPref.scalagon.alpha", default = 1)
 
-  # Use parallel computation? Default is FALSE!
-  if (isTRUE(getOption("rPref.parallel", default = FALSE))) {
-    # Get number of threads
-    # default is number of cores (from RcppParallel)
-    Npar <- getOption("rPref.parallel.threads", RcppParallel::defaultNumThreads())
-  } else {
-    Npar <- 1
+  # Number of threads, 1 if parallel computation is not activated
+  Npar <- get_num_threads()
+
+  # Maximal size (in MB) of the reusable buffers retained by each thread, default is 1
+  set_buffer_retention_impl(getOption("rPref.buffer.retention", default = 1))
+
+  # Evaluate only one tuple per class of identical score vectors? Default is FALSE
+  use_dedup <- isTRUE(getOption("rPref.dedup", default = FALSE))
+
+  # Use the bitmap skyline for small domains? Default is FALSE
+  use_bitmap <- isTRUE(getOption("rPref.bitmap", default = FALSE))
+
+  # ** Number of representative maxima (NULL for all maxima)
+
+  representative <- vars$representative
+  if (!is.null(representative)) {
+    if (!is.numeric(representative) || length(representative) != 1 || is.na(representative) || representative < 1) {
+      stop.syscall("Parameter representative must be a positive single integer value.")
+    }
+    if (is_top || is_grouped || isTRUE(vars$.async)) {
+      stop.syscall("Parameter representative is not supported in top-k, grouped or asynchronous preference selections.")
+    }
+    representative <- as.integer(min(representative, .Machine$integer.max))
+  }
+
+  # ** Approximate preference selection (epsilon-Skyline)
+
+  if (!is.null(vars$epsilon)) {
+    epsilon <- vars$epsilon
+    if (!is.numeric(epsilon) || length(epsilon) == 0 || anyNA(epsilon) || any(epsilon < 0)) {
+      stop.syscall("Parameter epsilon must contain non-negative numeric values.")
+    }
+    if (is_top || is_grouped || isTRUE(vars$.async)) {
+      stop.syscall("Parameter epsilon is not supported in top-k, grouped or asynchronous preference selections.")
+    }
+    epsilon_relative <- get.bool.from.lst(vars, "epsilon_relative")
+    res <- pref_select_eps_impl(scores, pref_serial, as.numeric(epsilon), epsilon_relative, Npar, alpha)
+    if (!is.null(representative)) res <- representative_impl(scores, pref_serial, res, representative)
+
+    # All C indices start at 0, and all R indices start at 1
+    if (!show_level) return(res + 1)
+    return(data.frame(.index = res + 1, .level = 1))
+  }
+
+  # ** Start an asynchronous preference selection (see psel.async)
+
+  if (isTRUE(vars$.async)) {
+    if (is_grouped) stop("Grouped data frames are not supported in an asynchronous preference selection.")
+    if (!is_top) {
+      top <- -1
+      at_least <- -1
+      top_level <- 1
+      and_connected <- TRUE
+    }
+    handle <- psel_async_impl(
+      scores, pref_serial, alpha, is_top,
+      top, at_least, top_level, and_connected, show_level, use_dedup, use_bitmap
+    )
+    return(structure(list(handle = handle, show_level = show_level), class = "psel_job"))
+  }
+
+  # ** Result of an identical (non-grouped) preference selection from the cache (see psel.cache)
+
+  cache_key <- NULL
+  if (!is_grouped && cache.size() > 0) {
+    settings <- if (is_top) c(top, at_least, top_level, and_connected) else NULL
+    # The options of the evaluation may choose other tuples with equal levels in a cut top-k selection
+    cache_key <- cache.key(scores, pref_serial, c(is_top, settings, show_level, representative, use_dedup, use_bitmap, Npar, alpha))
+    res <- cache.get(cache_key)
+    if (!is.null(res)) return(res)
   }
 
   # ** Finally do the (top-k) preference selection
@@ -307,24 +454,25 @@ psel.indices <- function(df, pref, ...) {
   if (!is_top) {
     # Do the preference selection - not-top-k
     if (!is_grouped) { # Usual preference selection (not grouped)
-      res <- pref_select_impl(scores, pref_serial, Npar, alpha) # non parallel for Npar=1
+      res <- pref_select_impl(scores, pref_serial, Npar, alpha, use_dedup, use_bitmap) # non parallel for Npar=1
+      if (!is.null(representative)) res <- representative_impl(scores, pref_serial, res, representative)
     } else { # Grouped preference selection
       res <- grouped_pref_sel_impl(group_indices, scores, pref_serial, Npar, alpha)
     }
 
     if (!show_level) { # just return indices
       # All C indices start at 0, and all R indices start at 1
-      return(res + 1)
+      res <- res + 1
     } else {
       # Add level values for is_top = FALSE, i.e., all level values are 1
-      return(data.frame(.index = res + 1, .level = 1))
+      res <- data.frame(.index = res + 1, .level = 1)
     }
   } else {
     # Do the top-k preference selection
     if (!is_grouped) { # Usual preference selection (not grouped)
       res <- pref_select_top_impl(
         scores, pref_serial, Npar, alpha,
-        top, at_least, top_level, and_connected, show_level
+        top, at_least, top_level, and_connected, show_level, use_dedup, use_bitmap
       )
     } else { # Grouped preference selection
       res <- grouped_pref_sel_top_impl(
@@ -336,11 +484,11 @@ psel.indices <- function(df, pref, ...) {
     # All C indices start at 0, and all R indices start at 1
     res[[".index"]] <- res[[".index"]] + 1
 
-    if (!show_level) {
-      return(res[[".index"]])
-    } # Return just indices
-    return(res) # Return Data.Frame(".index", ".level")
+    if (!show_level) res <- res[[".index"]] # Return just indices, otherwise Data.Frame(".index", ".level")
   }
+
+  if (!is.null(cache_key)) cache.put(cache_key, res)
+  return(res)
 }
 
 #' @export
@@ -354,6 +502,340 @@ peval <- function(pref, ...) {
 }
 
 
+#' Progressive Preference Selection
+#'
+#' Evaluates a preference progressively on a given data set, i.e.,
+#' the maxima are passed in chunks to a callback function as soon as they are confirmed.
+#' The evaluation can be stopped by a time limit, by the callback function, or by a user interrupt,
+#' returning the maxima found so far.
+#'
+#' @param df A data frame or a data frame extension (e.g. a tibble). Grouped data frames are not supported.
+#' @param pref A preference object. See \code{\link{psel}} for details.
+#' @param chunk_size Number of maxima which are passed to \code{callback} at once.
+#' @param timeout Time limit in seconds. After this time the evaluation stops and the maxima found so far are returned.
+#'                For \code{timeout = Inf} (the default) there is no time limit.
+#' @param callback (Optional) A function which is called with the row indices of each chunk of maxima.
+#'                 If it returns \code{FALSE}, the evaluation stops.
+#'
+#' @details
+#' The tuples are presorted such that all better tuples are read before a tuple.
+#' Hence a tuple which is not dominated by the maxima found so far is final.
+#' This is possible for all preferences composed of base preferences, Pareto, intersection,
+#' prioritization and reverse. For preferences containing a union (\code{+}) the maxima
+#' are calculated at once and then passed in chunks to \code{callback}.
+#'
+#' @return The row indices of the maxima found, in the order they were confirmed.
+#'         The attribute \code{complete} is \code{TRUE} if all maxima were found,
+#'         and \code{FALSE} if the evaluation was stopped before.
+#'
+#' @seealso See \code{\link{psel}} for the usual preference selection.
+#'
+#' @export
+#'
+#' @examples
+#'
+#' # Print the maxima in chunks of 2 tuples
+#' psel.progressive(mtcars, low(mpg) * low(hp), chunk_size = 2, callback = print)
+#'
+#' # Stop after the first chunk
+#' psel.progressive(mtcars, low(mpg) * low(hp), chunk_size = 2, callback = function(x) FALSE)
+#'
+psel.progressive <- function(df, pref, chunk_size = 100, timeout = Inf, callback = NULL) {
+  df.pref.check(df, pref)
+
+  if (dplyr::is.grouped_df(df)) stop.syscall("Grouped data frames are not supported in a progressive preference selection.")
+  if (!is.numeric(chunk_size) || length(chunk_size) != 1 || is.na(chunk_size) || chunk_size < 1) {
+    stop.syscall("Parameter chunk_size must be a positive single integer value.")
+  }
+  if (!is.numeric(timeout) || length(timeout) != 1 || is.na(timeout) || timeout <= 0) {
+    stop.syscall("Parameter timeout must be a positive single numeric value.")
+  }
+  if (!is.null(callback) && !is.function(callback)) stop.syscall("Parameter callback must be a function or NULL.")
+
+  # Precalculate score values for given preference, get_scores must be called before serialize!
+  res <- get_scores(pref, 1, df)
+  scores <- res$scores
+  pref_serial <- pserialize(res$p)
+
+  alpha <- getOption("rPref.scalagon.alpha", default = 1)
+
+  # Timeout 0 means "no time limit" in the C++ code
+  res <- pref_select_progressive_impl(
+    scores, pref_serial, alpha, as.integer(chunk_size),
+    if (is.finite(timeout)) timeout else 0, callback
+  )
+
+  # All C indices start at 0, and all R indices start at 1
+  indices <- res$index + 1
+  attr(indices, "complete") <- res$complete
+  return(indices)
+}
+
+
+#' Asynchronous Preference Selection
+#'
+#' Starts a preference selection in a background thread and returns immediately,
+#' such that the R session is not blocked during the evaluation.
+#' The returned job can be polled, waited for, or cancelled.
+#'
+#' @param df A data frame or a data frame extension (e.g. a tibble). Grouped data frames are not supported.
+#' @param pref A preference object. See \code{\link{psel}} for details.
+#' @param ... Additional (optional) parameters for top(-level)-k selections, see \code{\link{psel}}.
+#' @param job A job returned by \code{psel.async} or \code{psel.indices.async}.
+#' @param timeout Maximal time in seconds to wait for the job. For \code{timeout = Inf} (the default) there is no time limit.
+#'
+#' @details
+#' The scores of the preference are calculated and copied in the R session,
+#' afterwards the selection runs without any access to R.
+#' Several jobs can run at the same time, each in its own thread.
+#' The options \code{rPref.dedup} and \code{rPref.bitmap} are considered (see \code{\link{psel}}),
+#' the parallel computation within a job is not.
+#'
+#' \describe{
+#'   \item{\code{psel.async(df, pref, ...)}}{Starts a preference selection like \code{psel(df, pref, ...)}.}
+#'   \item{\code{psel.indices.async(df, pref, ...)}}{Starts a preference selection like \code{psel.indices(df, pref, ...)}.}
+#'   \item{\code{psel.poll(job)}}{Returns \code{TRUE} if the job is finished.}
+#'   \item{\code{psel.wait(job, timeout)}}{Waits until the job is finished or the timeout is reached.
+#'     Returns \code{TRUE} if the job is finished. A user interrupt stops waiting, but not the job.}
+#'   \item{\code{psel.cancel(job)}}{Cancels the job. It stops as soon as possible and has no result.}
+#'   \item{\code{psel.result(job)}}{Waits for the job and returns the result of the preference selection,
+#'     i.e., the same value as \code{psel} or \code{psel.indices}, respectively.}
+#' }
+#'
+#' A job which is no longer referenced is cancelled by the garbage collector.
+#'
+#' @seealso See \code{\link{psel}} for the usual preference selection.
+#'
+#' @name psel.async
+#' @export
+#'
+#' @examples
+#'
+#' job <- psel.async(mtcars, low(mpg) * low(hp), top = 5)
+#' psel.poll(job)
+#' psel.result(job)
+#'
+psel.async <- function(df, pref, ...) {
+  df.pref.check(df, pref)
+  sel <- psel.vars(list(...))
+  job <- psel.indices(df, pref, .dots = c(sel$vars, list(.async = TRUE)))
+  job$df <- df
+  job$show_index <- sel$show_index
+  return(job)
+}
+
+#' @rdname psel.async
+#' @export
+psel.indices.async <- function(df, pref, ...) {
+  df.pref.check(df, pref)
+  vars <- list(...)
+  if (".dots" %in% names(vars)) vars <- vars[[".dots"]]
+  return(psel.indices(df, pref, .dots = c(vars, list(.async = TRUE))))
+}
+
+#' @rdname psel.async
+#' @export
+psel.poll <- function(job) {
+  job.check(job)
+  return(psel_async_poll_impl(job$handle))
+}
+
+#' @rdname psel.async
+#' @export
+psel.wait <- function(job, timeout = Inf) {
+  job.check(job)
+  if (!is.numeric(timeout) || length(timeout) != 1 || is.na(timeout) || timeout <= 0) {
+    stop.syscall("Parameter timeout must be a positive single numeric value.")
+  }
+  # Timeout 0 means "no time limit" in the C++ code
+  return(psel_async_wait_impl(job$handle, if (is.finite(timeout)) timeout else 0))
+}
+
+#' @rdname psel.async
+#' @export
+psel.cancel <- function(job) {
+  job.check(job)
+  psel_async_cancel_impl(job$handle)
+}
+
+#' @rdname psel.async
+#' @export
+psel.result <- function(job) {
+  job.check(job)
+  psel_async_wait_impl(job$handle, 0)
+  res <- psel_async_result_impl(job$handle)
+
+  # All C indices start at 0, and all R indices start at 1
+  res[[".index"]] <- res[[".index"]] + 1
+  if (!job$show_level) res <- res[[".index"]]
+
+  # Job of psel.async: select rows
+  if (!is.null(job$df)) res <- psel.rows(job$df, res, job$show_level, job$show_index)
+  return(res)
+}
+
+job.check <- function(job) {
+  if (!inherits(job, "psel_job")) stop.syscall("Argument has to be a job returned by psel.async or psel.indices.async.")
+}
+
+
+
+#' Estimation of the Result Size
+#'
+#' Estimates the number of tuples in the first levels of a preference selection from a sample,
+#' without running the full selection.
+#'
+#' @param df A data frame or a data frame extension (e.g. a tibble). Grouped data frames are not supported.
+#' @param pref A preference object. See \code{\link{psel}} for details.
+#' @param levels Number of levels to be estimated, e.g., \code{levels = 1} (the default) estimates the number of maxima.
+#' @param sample_size Number of sampled tuples. If the data set is not larger, all tuples are evaluated.
+#' @param conf_level Confidence level of the bounds.
+#' @param max_dominators Maximal number of dominators of a sampled tuple for the calculation of its level (for \code{levels > 1}).
+#'
+#' @details
+#' For each sampled tuple the exact level is calculated from its dominators,
+#' where tuples which cannot be in the first \code{levels} levels according to the scaled lattice of Scalagon
+#' (see \code{\link{psel}}) are skipped. The dominators of a tuple are only searched in the cells of this lattice
+#' with smaller or equal coordinates and in the tuples outside of the lattice.
+#' Hence the effort grows with the sample size and the number of tuples,
+#' but is usually much smaller than the preference selection itself.
+#' For a tuple with more than \code{max_dominators} dominators, the level is calculated from a random subset
+#' of \code{max_dominators} dominators. This bounds the effort per sampled tuple, but the level may be underestimated
+#' (the level within the subset is a lower bound of the actual level).
+#' The sample is drawn with replacement using the random number generator of R, i.e., it is reproducible with \code{set.seed}.
+#'
+#' The bounds are Wilson score intervals for the fraction of tuples in each level, multiplied by the number of tuples.
+#' The lower bound is at least the number of distinct sampled tuples found in the level.
+#' As the level of a tuple with more than \code{max_dominators} dominators is only a lower bound,
+#' such a tuple is not counted for the lower bounds, but for the upper bounds of its level and all higher levels.
+#' The parallel computation (option \code{rPref.parallel}) is considered.
+#'
+#' @return A data frame with one row per level and the columns
+#'   \code{.level}, \code{estimate}, \code{lower} and \code{upper}.
+#'   The attribute \code{exact} is \code{TRUE} if all tuples were evaluated with all their dominators.
+#'
+#' @seealso See \code{\link{psel}} for the preference selection.
+#'
+#' @importFrom stats qnorm
+#' @export
+#'
+#' @examples
+#'
+#' df <- data.frame(x = runif(20000), y = runif(20000))
+#' psel.estimate(df, low(x) * low(y), levels = 3)
+#'
+psel.estimate <- function(df, pref, levels = 1, sample_size = 1000, conf_level = 0.95, max_dominators = 1000) {
+  df.pref.check(df, pref)
+
+  if (dplyr::is.grouped_df(df)) stop.syscall("Grouped data frames are not supported in an estimation of the result size.")
+  if (!is.numeric(levels) || length(levels) != 1 || is.na(levels) || levels < 1 || round(levels) != levels) {
+    stop.syscall("Parameter levels must be a positive single integer value.")
+  }
+  if (!is.numeric(sample_size) || length(sample_size) != 1 || is.na(sample_size) || sample_size < 1) {
+    stop.syscall("Parameter sample_size must be a positive single integer value.")
+  }
+  if (!is.numeric(conf_level) || length(conf_level) != 1 || is.na(conf_level) || conf_level <= 0 || conf_level >= 1) {
+    stop.syscall("Parameter conf_level must be a single numeric value in (0, 1).")
+  }
+  if (!is.numeric(max_dominators) || length(max_dominators) != 1 || is.na(max_dominators) || max_dominators < 1) {
+    stop.syscall("Parameter max_dominators must be a positive single integer value.")
+  }
+
+  # Precalculate score values for given preference, get_scores must be called before serialize!
+  res <- get_scores(pref, 1, df)
+  scores <- res$scores
+  pref_serial <- pserialize(res$p)
+
+  alpha <- getOption("rPref.scalagon.alpha", default = 1)
+
+  # Sampled tuples and their levels (0 for levels larger than "levels")
+  ntuples <- nrow(df)
+  sample_size <- min(sample_size, ntuples)
+  sampled <- psel_estimate_impl(scores, pref_serial, as.integer(sample_size), as.integer(levels),
+                                as.integer(min(max_dominators, .Machine$integer.max)), alpha, get_num_threads())
+  exact <- sample_size == ntuples && !any(sampled$.capped)
+
+  # Wilson score interval for the fraction of tuples with the given counts in the sample
+  n <- max(sample_size, 1)
+  z <- qnorm(1 - (1 - conf_level) / 2)
+  wilson <- function(counts, sgn) {
+    p <- counts / n
+    (p + z^2 / (2 * n) + sgn * z * sqrt(p * (1 - p) / n + z^2 / (4 * n^2))) / (1 + z^2 / n)
+  }
+
+  lev <- seq_len(levels)
+  estimate <- round(vapply(lev, function(l) sum(sampled$.level == l), 0) / n * ntuples)
+  if (exact) {
+    lower <- upper <- estimate
+  } else {
+    # The level of a capped tuple is a lower bound, it may be in any level from this one on
+    certain <- !sampled$.capped | sampled$.level == 0
+    in_level <- function(l) sampled$.level == l & certain
+    maybe_in_level <- function(l) sampled$.level == l | (!certain & sampled$.level < l)
+    counts_lower <- vapply(lev, function(l) sum(in_level(l)), 0)
+    counts_upper <- vapply(lev, function(l) sum(maybe_in_level(l)), 0)
+
+    # At least the distinct sampled tuples of the level are in the level
+    distinct <- vapply(lev, function(l) length(unique(sampled$.index[in_level(l)])), 0)
+    lower <- pmax(floor(pmax(wilson(counts_lower, -1), 0) * ntuples), distinct)
+    upper <- pmin(ceiling(wilson(counts_upper, 1) * ntuples), ntuples)
+  }
+
+  res <- data.frame(.level = lev, estimate = estimate, lower = lower, upper = upper)
+  attr(res, "exact") <- exact
+  return(res)
+}
+
+#' k-Skyband
+#'
+#' Returns the tuples which are dominated by less than \code{k} other tuples w.r.t. a preference,
+#' together with the exact number of their dominators.
+#'
+#' @param df A data frame or a data frame extension (e.g. a tibble). Grouped data frames are not supported.
+#' @param pref A preference object. See \code{\link{psel}} for details.
+#' @param k Positive integer, the maximal number of dominators is \code{k - 1}.
+#'
+#' @details
+#' The 1-skyband contains the maxima of the preference, i.e., the result of \code{psel}.
+#' Unlike the top-k selection with \code{top_level} (see \code{\link{psel}}), which ranks the tuples by the length of the
+#' longest chain of dominating tuples, the k-skyband ranks by the number of all dominating tuples,
+#' hence a tuple dominated only by a few tuples is kept even if these tuples are in different levels.
+#'
+#' The k-skyband is calculated by a variant of the BNL algorithm, which does not discard a tuple at the first dominator
+#' but keeps a counter of its dominators. Tuples which have at least \code{k} dominators according to the
+#' scaled lattice of Scalagon are discarded before. The parallel computation (option \code{rPref.parallel}) is considered.
+#'
+#' @return A data frame with the columns \code{.index} (row indices of the tuples in \code{df}, ascending)
+#'   and \code{.domcount} (number of dominating tuples).
+#'
+#' @seealso See \code{\link{psel}} for the preference selection.
+#'
+#' @export
+#'
+#' @examples
+#'
+#' # Cars which are dominated by at most 2 other cars
+#' res <- psel.skyband(mtcars, low(mpg) * high(hp), k = 3)
+#' cbind(mtcars[res$.index, c("mpg", "hp")], res[".domcount"])
+#'
+psel.skyband <- function(df, pref, k = 1) {
+  df.pref.check(df, pref)
+
+  if (dplyr::is.grouped_df(df)) stop.syscall("Grouped data frames are not supported in a k-skyband.")
+  if (!is.numeric(k) || length(k) != 1 || is.na(k) || k < 1 || round(k) != k) {
+    stop.syscall("Parameter k must be a positive single integer value.")
+  }
+
+  # Precalculate score values for given preference, get_scores must be called before serialize!
+  res <- get_scores(pref, 1, df)
+  alpha <- getOption("rPref.scalagon.alpha", default = 1)
+  res <- psel_skyband_impl(res$scores, pserialize(res$p), as.integer(min(k, nrow(df) + 1)), alpha, get_num_threads())
+
+  # All C indices start at 0, and all R indices start at 1
+  res$.index <- res$.index + 1
+  return(res)
+}
+
 # Helper for top-k parameters
 get.top.param.from.lst <- function(lst, name, inf_default) {
   if (!(name %in% names(lst))) {
@@ -407,3 +889,15 @@ stop.syscall <- function(message) {
   message <- paste0("Error in ", deparse(sys.calls()[[sys.nframe() - 2]]), " : ", message)
   stop(message, call. = FALSE)
 }
+
+
+# Use parallel computation? Default is FALSE!
+get_num_threads <- function() {
+  if (isTRUE(getOption("rPref.parallel", default = FALSE))) {
+    # Get number of threads
+    # default is number of cores (from RcppParallel)
+    return(getOption("rPref.parallel.threads", RcppParallel::defaultNumThreads()))
+  } else {
+    return(1)
+  }
+}
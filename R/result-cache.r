@@ -0,0 +1,108 @@
+# Result cache for preference selections
+# --------------------------------------
+
+# Results of non-grouped preference selections, stored by the fingerprint (128 bits) of the scores and the key
+# (serialized preference and settings). The entries are list(key, res), where the key is compared on a hit,
+# and the names of the entries are ordered from the least to the most recently used.
+# The score columns are not stored, such that the cache does not keep copies of large data sets.
+cache.env <- new.env(parent = emptyenv())
+cache.env$entries <- new.env(hash = TRUE, parent = emptyenv())
+cache.env$order <- character(0)
+cache.env$hits <- 0
+cache.env$misses <- 0
+
+
+#' Result Cache
+#'
+#' Statistics and reset of the cache for the results of preference selections.
+#'
+#' @details
+#' With the option \code{rPref.cache.size} the results of the last non-grouped preference selections
+#' (\code{psel}, \code{psel.indices} and \code{peval}) are cached in the R session.
+#' The cache is disabled by default (size 0). To keep the results of the last 20 selections, use:
+#'
+#' \code{options(rPref.cache.size = 20)}
+#'
+#' A selection is answered from the cache if the score values of the preference, the preference itself,
+#' the top-k parameters and the options of the evaluation (\code{rPref.dedup}, \code{rPref.bitmap},
+#' \code{rPref.scalagon.alpha} and the number of threads) are identical to a cached selection.
+#' The score values are compared by a fingerprint of 128 bits, hence the cache is also used for a modified data frame
+#' as long as the attributes of the preference are unchanged, and the cache does not keep the score values in memory.
+#' If the cache is full, the least recently used result is removed.
+#'
+#' \describe{
+#'   \item{\code{psel.cache.stats()}}{Returns a list with the number of \code{hits} and \code{misses}
+#'     since the last reset, the number of cached results (\code{entries}) and the maximal number (\code{size}).}
+#'   \item{\code{psel.cache.clear()}}{Removes all cached results and resets the statistics.}
+#' }
+#'
+#' @seealso See \code{\link{psel}} for the preference selection.
+#'
+#' @name psel.cache
+#' @export
+#'
+#' @examples
+#'
+#' old <- options(rPref.cache.size = 10)
+#' psel(mtcars, low(mpg) * low(hp))
+#' psel(mtcars, low(mpg) * low(hp))
+#' psel.cache.stats()
+#' psel.cache.clear()
+#' options(old)
+#'
+psel.cache.stats <- function() {
+  return(list(
+    hits = cache.env$hits, misses = cache.env$misses,
+    entries = length(cache.env$order), size = cache.size()
+  ))
+}
+
+#' @rdname psel.cache
+#' @export
+psel.cache.clear <- function() {
+  rm(list = cache.env$order, envir = cache.env$entries)
+  cache.env$order <- character(0)
+  cache.env$hits <- 0
+  cache.env$misses <- 0
+  invisible(NULL)
+}
+
+
+# Maximal number of cached results, 0 if the cache is disabled
+cache.size <- function() {
+  size <- getOption("rPref.cache.size", default = 0)
+  if (!is.numeric(size) || length(size) != 1 || is.na(size) || size < 0) {
+    stop("The option rPref.cache.size must be a single non-negative number.")
+  }
+  return(size)
+}
+
+# Key for a preference selection, the top-k settings and the options of the evaluation are a vector
+cache.key <- function(scores, pref_serial, settings) {
+  key <- paste(c(deparse(pref_serial), settings), collapse = "|")
+  return(list(id = get_fingerprint_impl(scores, key), key = key))
+}
+
+# Cached result or NULL
+cache.get <- function(key) {
+  entry <- cache.env$entries[[key$id]]
+  if (is.null(entry) || !identical(entry$key, key$key)) {
+    cache.env$misses <- cache.env$misses + 1
+    return(NULL)
+  }
+  cache.env$hits <- cache.env$hits + 1
+  cache.env$order <- c(cache.env$order[cache.env$order != key$id], key$id)
+  return(entry$res)
+}
+
+cache.put <- function(key, res) {
+  assign(key$id, list(key = key$key, res = res), envir = cache.env$entries)
+  cache.env$order <- c(cache.env$order[cache.env$order != key$id], key$id)
+
+  # Remove the least recently used results
+  nremove <- length(cache.env$order) - cache.size()
+  if (nremove > 0) {
+    rm(list = cache.env$order[seq_len(nremove)], envir = cache.env$entries)
+    cache.env$order <- cache.env$order[-seq_len(nremove)]
+  }
+}
@@ -0,0 +1,90 @@
+#' R-tree Index for Preference Selections
+#'
+#' Creates a reusable index on numeric attributes of a data set, which evaluates Pareto preferences
+#' on any subset of these attributes by a branch and bound search.
+#'
+#' @param df A data frame or a data frame extension (e.g. a tibble).
+#' @param vars Names of the numeric attributes of \code{df} for the index. The attributes must contain finite values only (no \code{NA} or infinite values).
+#' @param index An index created by \code{psel.rtree.index}.
+#' @param pref A Pareto preference like \code{low(a) * high(b) * -low(c)}, where all base preferences are \code{low} or \code{high}
+#'             preferences on single attributes of the index (possibly reversed).
+#' @param top_level Integer. All tuples from the \code{top_level} best levels are returned.
+#'                  See \code{\link{psel}} for the definition of a level.
+#' @param show_level Logical value. If \code{TRUE}, a data frame with the columns \code{.index} and \code{.level} is returned.
+#'
+#' @details
+#' The index is an R-tree, which is bulk loaded by sorting and tiling the tuples in all dimensions.
+#' A query visits the nodes and tuples in ascending order of the sum of their best values (according to the directions
+#' of the preference), i.e., all tuples dominating a tuple are visited before the tuple itself.
+#' Nodes which are dominated by a tuple of the last requested level are skipped with all their tuples.
+#' This branch and bound search (BBS) visits only a small part of the tuples for many data sets,
+#' and the index can be used for many preferences on the same data set.
+#'
+#' The result is identical to \code{psel.indices(df, pref, top_level = top_level, show_level = show_level)}
+#' (up to the order of the tuples, which are ordered by level and row index).
+#'
+#' @return \code{psel.rtree.index} returns an index object.
+#'   \code{psel.rtree} returns the row indices of the selected tuples, or a data frame with the columns
+#'   \code{.index} and \code{.level} for \code{show_level = TRUE}.
+#'
+#' @seealso See \code{\link{psel}} for the preference selection.
+#'
+#' @export
+#'
+#' @examples
+#'
+#' idx <- psel.rtree.index(mtcars, c("mpg", "hp", "wt"))
+#' psel.rtree(idx, high(mpg) * high(hp))
+#' psel.rtree(idx, low(wt) * high(hp), top_level = 2, show_level = TRUE)
+#'
+psel.rtree.index <- function(df, vars) {
+  if (!is.data.frame(df)) stop.syscall("First argument has to be a data frame or a data frame extension.")
+  if (!is.character(vars) || length(vars) == 0 || !all(vars %in% names(df))) {
+    stop.syscall("Parameter vars must contain names of attributes of the data frame.")
+  }
+  raw <- as.data.frame(lapply(vars, function(v) df[[v]]))
+  if (!all(vapply(raw, is.numeric, TRUE))) stop.syscall("All attributes of the index must be numeric.")
+  if (!all(vapply(raw, function(col) all(is.finite(col)), TRUE))) {
+    stop.syscall("The attributes of the index must not contain NA or infinite values.")
+  }
+
+  return(structure(list(handle = rtree_index_impl(raw), vars = vars), class = "psel_rtree_index"))
+}
+
+#' @rdname psel.rtree.index
+#' @export
+psel.rtree <- function(index, pref, top_level = 1, show_level = FALSE) {
+  if (!inherits(index, "psel_rtree_index")) stop.syscall("First argument has to be an index created by psel.rtree.index.")
+  if (!is.actual.preference(pref)) stop.syscall("Second argument has to be a preference.")
+  if (!is.numeric(top_level) || length(top_level) != 1 || is.na(top_level) || top_level < 1 || round(top_level) != top_level) {
+    stop.syscall("Parameter top_level must be a positive single integer value.")
+  }
+
+  terms <- pareto.columns(pref, index$vars)
+  res <- rtree_skyline_impl(index$handle, terms$cols - 1L, terms$dirs, as.integer(min(top_level, .Machine$integer.max)))
+
+  # All C indices start at 0, and all R indices start at 1
+  res[[".index"]] <- res[[".index"]] + 1
+  if (!show_level) res <- res[[".index"]]
+  return(res)
+}
+
+# Columns (R indices in vars) and directions (1 for low, -1 for high) of a Pareto composition
+# of (possibly reversed) low/high preferences on single attributes
+pareto.columns <- function(pref, vars) {
+  terms <- lapply(pareto.terms(pref), function(p) {
+    dir <- 1
+    while (is.reversepref(p)) {
+      dir <- -dir
+      p <- p@p
+    }
+    if (!(is.lowpref(p) || is.highpref(p)) || is.distpref(p) || !is.name(p@lazy_expr$expr) ||
+        !(as.character(p@lazy_expr$expr) %in% vars)) {
+      stop("The preference must be a Pareto composition of low/high preferences on the attributes ",
+           paste(vars, collapse = ", "), ".", call. = FALSE)
+    }
+    if (is.highpref(p)) dir <- -dir
+    c(match(as.character(p@lazy_expr$expr), vars), dir)
+  })
+  return(list(cols = as.integer(vapply(terms, `[`, 0, 1)), dirs = as.integer(vapply(terms, `[`, 0, 2))))
+}
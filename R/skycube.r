@@ -0,0 +1,84 @@
+#' Skycube
+#'
+#' Precomputes the Skylines of all Pareto preferences on subsets of some numeric attributes,
+#' such that each of these preferences is answered by a lookup.
+#'
+#' @param df A data frame or a data frame extension (e.g. a tibble).
+#' @param vars Names of the numeric attributes of \code{df} for the skycube. The attributes must not contain \code{NA} values.
+#' @param directions Directions of the attributes in the precomputed preferences, each one of \code{"low"}, \code{"high"}
+#'                   or \code{"both"} (recycled to the length of \code{vars}).
+#' @param compress If \code{TRUE}, the Skylines are stored as variable length differences of the row indices.
+#' @param cube A skycube created by \code{psel.skycube}.
+#' @param pref A Pareto preference like \code{low(a) * high(b)}, where all base preferences are \code{low} or \code{high}
+#'             preferences on single attributes of the skycube (possibly reversed) according to the \code{directions}.
+#'
+#' @details
+#' The skycube contains the Skylines of all subspaces, i.e., all Pareto preferences on non-empty subsets of \code{vars},
+#' where each attribute is minimized (\code{low}) or maximized (\code{high}) according to \code{directions}.
+#' For \code{k} attributes with the direction \code{"low"} these are \code{2^k - 1} Skylines,
+#' for the direction \code{"both"} these are \code{3^k - 1} Skylines. At most 12 attributes are supported.
+#'
+#' The Skylines of the subspaces with all attributes are calculated from all tuples.
+#' Each smaller subspace is derived from the smallest Skyline of a subspace with one additional attribute:
+#' A maximum of the smaller subspace is either a maximum of the larger subspace, or it is equal (on the smaller subspace)
+#' to a maximum of the larger subspace. The subspaces with the same number of attributes are calculated in parallel,
+#' if the parallel computation is activated (see \code{\link{psel}}).
+#'
+#' The elements \code{subspaces} and \code{bytes} of the skycube contain the number of subspaces and the memory used
+#' for the stored Skylines.
+#'
+#' @return \code{psel.skycube} returns the skycube, \code{psel.skycube.get} returns the row indices (ascending)
+#'   of the maxima of the preference, like \code{sort(psel.indices(df, pref))}.
+#'
+#' @seealso See \code{\link{psel}} for the preference selection.
+#'
+#' @export
+#'
+#' @examples
+#'
+#' cube <- psel.skycube(mtcars, c("mpg", "hp", "wt", "qsec"), directions = c("high", "both", "low", "low"))
+#' psel.skycube.get(cube, high(mpg) * low(hp))
+#' psel.skycube.get(cube, high(hp) * low(wt) * low(qsec))
+#'
+psel.skycube <- function(df, vars, directions = "low", compress = FALSE) {
+  if (!is.data.frame(df)) stop.syscall("First argument has to be a data frame or a data frame extension.")
+  if (!is.character(vars) || length(vars) == 0 || !all(vars %in% names(df)) || anyDuplicated(vars)) {
+    stop.syscall("Parameter vars must contain distinct names of attributes of the data frame.")
+  }
+  if (length(vars) > 12) stop.syscall("A skycube supports at most 12 attributes.")
+  if (!is.character(directions) || length(directions) == 0 || !all(directions %in% c("low", "high", "both"))) {
+    stop.syscall("Parameter directions must contain the values \"low\", \"high\" or \"both\".")
+  }
+  raw <- as.data.frame(lapply(vars, function(v) df[[v]]))
+  if (!all(vapply(raw, is.numeric, TRUE))) stop.syscall("All attributes of the skycube must be numeric.")
+  if (any(vapply(raw, anyNA, TRUE))) stop.syscall("The attributes of the skycube must not contain NA values.")
+
+  directions <- rep_len(directions, length(vars))
+  alpha <- getOption("rPref.scalagon.alpha", default = 1)
+  handle <- skycube_impl(raw, match(directions, c("low", "high", "both")), isTRUE(compress), alpha, get_num_threads())
+  info <- skycube_info_impl(handle)
+
+  return(structure(list(handle = handle, vars = vars, directions = directions,
+                        subspaces = info$subspaces, bytes = info$bytes), class = "psel_skycube"))
+}
+
+#' @rdname psel.skycube
+#' @export
+psel.skycube.get <- function(cube, pref) {
+  if (!inherits(cube, "psel_skycube")) stop.syscall("First argument has to be a skycube created by psel.skycube.")
+  if (!is.actual.preference(pref)) stop.syscall("Second argument has to be a preference.")
+
+  # Digits of the subspace: 0 (not contained), 1 (low) or 2 (high)
+  terms <- pareto.columns(pref, cube$vars)
+  digits <- integer(length(cube$vars))
+  for (i in seq_along(terms$cols)) {
+    d <- if (terms$dirs[i] == 1) 1L else 2L
+    if (digits[terms$cols[i]] != 0 && digits[terms$cols[i]] != d) {
+      stop.syscall("Each attribute may be used only in one direction.")
+    }
+    digits[terms$cols[i]] <- d
+  }
+
+  # All C indices start at 0, and all R indices start at 1
+  return(skycube_get_impl(cube$handle, digits) + 1)
+}
@@ -0,0 +1,122 @@
+#' Skyline Join
+#'
+#' Returns the maxima of a preference over the inner join of two data frames,
+#' without evaluating the preference on the full join.
+#'
+#' @param x,y Data frames or data frame extensions (e.g. tibbles) to be joined. Grouped data frames are not supported.
+#' @param pref A preference on the attributes of the joined data frame. See \code{\link{psel}} for details.
+#' @param by Join attributes as in \code{\link[dplyr]{inner_join}}, i.e., a character vector of common attributes,
+#'           or a named character vector like \code{c("a" = "b")} to join \code{x$a} and \code{y$b}.
+#'           By default, all common attributes of \code{x} and \code{y} are used.
+#'
+#' @details
+#' The result is identical to \code{psel(dplyr::inner_join(x, y, by = by), pref)} (up to the order of the rows).
+#'
+#' If \code{pref} is a Pareto composition \code{p1 * p2 * ...}, where each \code{pk} depends only on the attributes
+#' of \code{x} or only on the attributes of \code{y} (or only on the join attributes) and is evaluated element-wise
+#' (e.g., \code{low(a + b)}, but not \code{low(a - mean(a))}), a tuple of \code{x} which is
+#' dominated by another tuple with the same join attributes w.r.t. the Pareto composition of its \code{pk}
+#' cannot be part of a maximal joined tuple, and analogously for \code{y}.
+#' Hence the Skylines of the groups with identical join attributes are calculated on both sides first
+#' (see the grouping in \code{\link{psel}}), and only the remaining tuples are joined and evaluated by a final preference selection.
+#' For preferences which cannot be split in this way, only the tuples without a join partner are removed before the join.
+#'
+#' @return The maximal tuples of the joined data frame.
+#'
+#' @seealso See \code{\link{psel}} for the preference selection.
+#'
+#' @importFrom dplyr inner_join semi_join
+#' @export
+#'
+#' @examples
+#'
+#' # Cheapest and fastest offers for each product, where the price
+#' # is given by the products and the delivery time by the shops
+#' products <- data.frame(shop = rep(1:5, each = 4), price = round(runif(20, 10, 20)))
+#' shops <- data.frame(shop = 1:5, days = c(1, 3, 2, 5, 2))
+#' psel.join(products, shops, low(price) * low(days), by = "shop")
+#'
+psel.join <- function(x, y, pref, by = NULL) {
+  if (!is.data.frame(x) || !is.data.frame(y)) stop.syscall("The arguments x and y have to be data frames or data frame extensions.")
+  if (dplyr::is.grouped_df(x) || dplyr::is.grouped_df(y)) stop.syscall("Grouped data frames are not supported in a Skyline join.")
+  if (!is.actual.preference(pref)) stop.syscall("Third argument has to be a preference.")
+
+  # Join attributes of both sides
+  if (is.null(by)) by <- intersect(names(x), names(y))
+  if (!is.character(by) || length(by) == 0) stop.syscall("Parameter by must be a non-empty character vector.")
+  by_y <- unname(by)
+  by_x <- if (is.null(names(by))) by_y else ifelse(names(by) == "", by_y, names(by))
+  if (!all(by_x %in% names(x)) || !all(by_y %in% names(y))) stop.syscall("The join attributes must be attributes of x and y.")
+
+  # Only tuples with a join partner
+  x <- dplyr::semi_join(x, y, by = by)
+  y <- dplyr::semi_join(y, x, by = stats::setNames(by_x, by_y))
+
+  # Local Skylines for the terms depending only on one side
+  # (attributes in both x and y get the suffixes ".x" and ".y" in the join, terms using them are not split)
+  attr_x <- setdiff(names(x), by_x)
+  attr_y <- setdiff(names(y), by_y)
+  common <- intersect(attr_x, attr_y)
+  terms <- pareto.terms(pref)
+  cols <- c(names(x), names(y), paste0(common, ".x"), paste0(common, ".y"))
+  side <- vapply(terms, function(p) {
+    # Terms like low(a - mean(a)) depend on all tuples, which differ before and after the join
+    if (!is.pointwise.pref(p, cols)) return("xy")
+    vars <- pref.vars(p)
+    in_x <- any(vars %in% attr_x)
+    in_y <- any(vars %in% attr_y)
+    if ((in_x && in_y) || any(vars %in% c(paste0(common, ".x"), paste0(common, ".y")))) "xy" else if (in_x) "x" else if (in_y) "y" else ""
+  }, "")
+
+  if (!any(side == "xy")) {
+    if (any(side == "x")) x <- local.skyline(x, by_x, terms[side == "x"])
+    if (any(side == "y")) y <- local.skyline(y, by_y, terms[side == "y"])
+  }
+
+  return(psel(dplyr::inner_join(x, y, by = by), pref))
+}
+
+# Terms of a Pareto composition p1 * p2 * ...
+pareto.terms <- function(pref) {
+  if (inherits(pref, "paretopref")) return(c(pareto.terms(pref@p1), pareto.terms(pref@p2)))
+  return(list(pref))
+}
+
+# Names used in the expressions of a preference (attributes and other variables)
+pref.vars <- function(pref) {
+  if (is.binarycomplexpref(pref)) return(union(pref.vars(pref@p1), pref.vars(pref@p2)))
+  if (is.reversepref(pref)) return(pref.vars(pref@p))
+  if (inherits(pref, "basepref")) return(all.vars(pref@lazy_expr$expr))
+  return(character(0))
+}
+
+# Functions which are evaluated element-wise, i.e., the value for a tuple does not depend on the other tuples
+pointwise.funs <- c("+", "-", "*", "/", "^", "%%", "%/%", "(", "abs", "sign", "sqrt", "exp", "expm1", "log", "log2", "log10",
+                    "log1p", "floor", "ceiling", "round", "signif", "trunc", "sin", "cos", "tan", "pmin", "pmax", "ifelse",
+                    "==", "!=", "<", ">", "<=", ">=", "&", "|", "!", "is.na", "as.numeric", "as.integer", "%in%")
+
+# TRUE if all expressions of a preference are evaluated element-wise on the attributes cols
+is.pointwise.pref <- function(pref, cols) {
+  if (is.binarycomplexpref(pref)) return(is.pointwise.pref(pref@p1, cols) && is.pointwise.pref(pref@p2, cols))
+  if (is.reversepref(pref)) return(is.pointwise.pref(pref@p, cols))
+  if (inherits(pref, "basepref")) return(is.pointwise.expr(pref@lazy_expr$expr, cols))
+  return(TRUE)
+}
+
+is.pointwise.expr <- function(expr, cols) {
+  vars <- all.vars(expr)
+  if ("df__" %in% vars) return(FALSE)
+  if (!is.call(expr) || !any(vars %in% cols)) return(TRUE) # attribute, or constant for all tuples
+  fun <- expr[[1]]
+  if (!is.name(fun) || !(as.character(fun) %in% pointwise.funs)) return(FALSE)
+  args <- as.list(expr)[-1]
+  if (identical(fun, as.name("%in%")) && any(all.vars(args[[2]]) %in% cols)) return(FALSE)
+  return(all(vapply(args, is.pointwise.expr, TRUE, cols)))
+}
+
+# Maxima of the Pareto composition of the terms within each group of identical join attributes
+local.skyline <- function(df, by, terms) {
+  if (nrow(df) == 0) return(df)
+  grouped <- dplyr::group_by(df, dplyr::across(dplyr::all_of(by)))
+  return(df[sort(psel.indices(grouped, Reduce(`*`, terms))), , drop = FALSE])
+}
@@ -0,0 +1,107 @@
+#' Sliding Window Skyline
+#'
+#' Maintains the maxima of a preference over the latest tuples of a stream,
+#' i.e., over a window of the last \code{size} tuples and/or the tuples of the last \code{duration} time units.
+#'
+#' @param pref A preference object. See \code{\link{psel}} for details.
+#' @param size Number of the latest tuples in the window. For \code{size = Inf} (the default) the number is not limited.
+#' @param duration Time span of the window, i.e., the window contains all tuples with a time larger than
+#'                 the time of the latest tuple minus \code{duration}.
+#'                 For \code{duration = Inf} (the default) the time span is not limited.
+#' @param window A sliding window returned by \code{psel.window}.
+#' @param df A data frame with the new tuples of the stream, containing all attributes of the preference.
+#' @param time (Optional) Times of the new tuples (numeric or \code{POSIXct}, non-decreasing), required if \code{duration} is finite.
+#' @param show_index If \code{TRUE}, the column \code{.index} contains the number of each tuple in the stream, starting at 1.
+#'
+#' @details
+#' Only the tuples of the window which are not dominated by a younger tuple are retained,
+#' as all other tuples can never become maxima. When a tuple arrives, it is compared once with the retained tuples,
+#' and the retained tuples which have expired or are dominated by the new tuple are removed.
+#' A retained tuple is a maximum as soon as its youngest dominator has expired.
+#' Hence the effort per tuple depends on the number of retained tuples, not on the size of the window.
+#'
+#' \describe{
+#'   \item{\code{psel.window(pref, size, duration)}}{Creates an empty window. At least one of \code{size} and \code{duration} must be finite.}
+#'   \item{\code{psel.window.push(window, df, time)}}{Adds the tuples of \code{df} in the order of the rows, and returns the window invisibly.}
+#'   \item{\code{psel.window.get(window, show_index)}}{Returns the maxima of the window (in the order of arrival), \code{NULL} if no tuples were added yet.}
+#' }
+#'
+#' The retained tuples are stored in the window object, which is modified by \code{psel.window.push}.
+#'
+#' @seealso See \code{\link{psel}} for the preference selection.
+#'
+#' @name psel.window
+#' @export
+#'
+#' @examples
+#'
+#' # Maxima of the last 10 cars
+#' win <- psel.window(low(mpg) * low(hp), size = 10)
+#' for (i in 1:4) psel.window.push(win, mtcars[(8 * i - 7):(8 * i), ])
+#' psel.window.get(win, show_index = TRUE)
+#'
+psel.window <- function(pref, size = Inf, duration = Inf) {
+  if (!is.actual.preference(pref)) stop.syscall("First argument has to be a preference.")
+  if (!is.numeric(size) || length(size) != 1 || is.na(size) || size < 1) {
+    stop.syscall("Parameter size must be a positive single numeric value.")
+  }
+  if (!is.numeric(duration) || length(duration) != 1 || is.na(duration) || duration <= 0) {
+    stop.syscall("Parameter duration must be a positive single numeric value.")
+  }
+  if (is.infinite(size) && is.infinite(duration)) stop.syscall("At least one of the parameters size and duration must be finite.")
+
+  window <- new.env(parent = emptyenv())
+  window$pref <- pref
+  window$timed <- is.finite(duration)
+  window$handle <- psel_window_impl(size, duration)
+  window$rows <- NULL # retained tuples
+  window$arrivals <- numeric(0)
+  window$skyline <- numeric(0)
+  class(window) <- "psel_window"
+  return(window)
+}
+
+#' @rdname psel.window
+#' @export
+psel.window.push <- function(window, df, time = NULL) {
+  window.check(window)
+  df.pref.check(df, window$pref)
+  if (dplyr::is.grouped_df(df)) stop.syscall("Grouped data frames are not supported in a sliding window.")
+
+  if (is.null(time)) {
+    if (window$timed) stop.syscall("Parameter time is required for a window with a finite duration.")
+    time <- rep(0, nrow(df))
+  } else {
+    time <- as.numeric(time)
+    if (length(time) != nrow(df)) stop.syscall("Parameter time must have one value for each row.")
+  }
+  if (nrow(df) == 0) return(invisible(window))
+
+  # Retained tuples followed by the new tuples
+  all <- if (is.null(window$rows)) df else rbind(window$rows, df)
+
+  # Precalculate score values for given preference, get_scores must be called before serialize!
+  res <- get_scores(window$pref, 1, all)
+  upd <- psel_window_push_impl(window$handle, res$scores, pserialize(res$p), time)
+
+  # All C indices start at 0, and all R indices start at 1
+  window$rows <- all[upd$positions + 1, , drop = FALSE]
+  window$arrivals <- upd$arrivals + 1
+  window$skyline <- upd$skyline + 1
+  return(invisible(window))
+}
+
+#' @rdname psel.window
+#' @export
+psel.window.get <- function(window, show_index = FALSE) {
+  window.check(window)
+  if (is.null(window$rows)) return(NULL)
+
+  res <- window$rows[window$skyline, , drop = FALSE]
+  if (show_index) res[[".index"]] <- window$arrivals[window$skyline]
+  return(res)
+}
+
+window.check <- function(window) {
+  if (!inherits(window, "psel_window")) stop.syscall("Argument has to be a sliding window returned by psel.window.")
+}
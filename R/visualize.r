@@ -403,7 +403,11 @@ plot_front <- function(df, pref, ...) {
   maxima <- psel(df, pref)
 
   # Get evaluated expressions (similar to score values, but for "high" we have to negate)
-  scores <- get_scores(pref, 1, maxima)$scores
+  res <- get_scores(pref, 1, maxima)
+  scores <- res$scores
+  # For around/between the scores are the raw values
+  if (is.raw.distpref(res$p@p1)) scores[, 1] <- dist_values(res$p@p1, scores[, 1])
+  if (is.raw.distpref(res$p@p2)) scores[, 2] <- dist_values(res$p@p2, scores[, 2])
   if (is.highpref(pref@p1)) scores[, 1] <- -scores[, 1]
   if (is.highpref(pref@p2)) scores[, 2] <- -scores[, 2]
 
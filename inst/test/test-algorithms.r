@@ -62,5 +62,31 @@ for (parallelity in c(FALSE, TRUE)) {
       expect_equal(arrange(psel.indices(df2g, high(x1) %op% low(x2), at_least = 20, show_level = TRUE), .index), set2)
       expect_equal(arrange(psel.indices(df3, high(x1) %op% (true(x2 < 0.5) * low(x3)), top_level = 2, show_level = TRUE), .index), set3)
     })
+
+    test_that("Compare bounded top-k with top-level-k selection", {
+      df3 <- gen_data(1E5, -0.6, 3)
+
+      # top-k with and-connection stops as soon as k tuples are confirmed
+      res <- psel.indices(df3, low(x1) %op% (low(x2) & high(x3)), top = 100, show_level = TRUE)
+      expect_equal(nrow(res), 100)
+
+      # Compare level values with the (unbounded) top-level-k selection
+      all_lev <- psel.indices(df3, low(x1) %op% (low(x2) & high(x3)), top_level = max(res$.level), show_level = TRUE)
+      expect_true(all(res$.index %in% all_lev$.index))
+      expect_equal(res$.level, all_lev$.level[match(res$.index, all_lev$.index)])
+      expect_equal(sum(res$.level < max(res$.level)), sum(all_lev$.level < max(res$.level)))
+    })
   }
 }
+
+test_that("Compare parallel level peeling with serial top-k selection", {
+  df3 <- gen_data(2E4, -0.6, 3)
+  old <- options(rPref.parallel = FALSE)
+  set1 <- arrange(psel.indices(df3, low(x1) * low(x2) * high(x3), top_level = 5, show_level = TRUE), .index)
+  set2 <- arrange(psel.indices(df3, low(x1) * (low(x2) & low(x3)), top = Inf, show_level = TRUE), .index)
+
+  options(rPref.parallel = TRUE, rPref.parallel.threads = 4)
+  expect_equal(arrange(psel.indices(df3, low(x1) * low(x2) * high(x3), top_level = 5, show_level = TRUE), .index), set1)
+  expect_equal(arrange(psel.indices(df3, low(x1) * (low(x2) & low(x3)), top = Inf, show_level = TRUE), .index), set2)
+  options(old)
+})
@@ -81,6 +81,49 @@ test_that("Test predecessors and successors", {
   expect_equal(all_pred(p, c(3,4), intersect = TRUE), 2)
 })
 
+# All predecessors/successors agree with the comparison of the preference (also in parallel)
+test_that("Test all predecessors/successors on mtcars", {
+  p <- high(mpg) * low(wt) | low(cyl)
+  init_pred_succ(p, mtcars)
+  inds <- c(3, 10, 15, 20)
+  better <- function(i, j) with(mtcars, mpg[i] >= mpg[j] & wt[i] <= wt[j] & (mpg[i] > mpg[j] | wt[i] < wt[j]) & cyl[i] < cyl[j])
+  all_inds <- 1:nrow(mtcars)
+  dom <- lapply(inds, function(x) which(better(all_inds, x)))
+  sub <- lapply(inds, function(x) which(better(x, all_inds)))
+
+  expect_equal(all_pred(p, inds), sort(Reduce(union, dom)))
+  expect_equal(all_pred(p, inds, intersect = TRUE), sort(Reduce(intersect, dom)))
+  expect_equal(all_succ(p, inds), sort(Reduce(union, sub)))
+  old <- options(rPref.parallel = TRUE, rPref.parallel.threads = 3)
+  expect_equal(all_succ(p, inds, intersect = TRUE), sort(Reduce(intersect, sub)))
+  expect_equal(all_pred(p, inds), sort(Reduce(union, dom)))
+  options(old)
+  expect_error(all_succ(p, 100))
+})
+
+# Direct predecessors/successors agree with the Hasse diagram
+test_that("Test direct predecessors/successors on mtcars", {
+  p <- high(mpg) * low(wt) | low(cyl)
+  init_pred_succ(p, mtcars)
+  better <- function(i, j) with(mtcars, mpg[i] >= mpg[j] & wt[i] <= wt[j] & (mpg[i] > mpg[j] | wt[i] < wt[j]) & cyl[i] < cyl[j])
+  all_inds <- 1:nrow(mtcars)
+  # Edge of the transitive reduction if there is no tuple between i and j
+  direct <- function(i, j) better(i, j) && !any(better(i, all_inds) & better(all_inds, j))
+  for (i in c(1, 5, 17, 30)) {
+    expect_equal(hasse_succ(p, i), all_inds[vapply(all_inds, function(j) direct(i, j), TRUE)])
+    expect_equal(hasse_pred(p, i), all_inds[vapply(all_inds, function(j) direct(j, i), TRUE)])
+  }
+  # Cached neighborhoods give the same results
+  expect_equal(hasse_succ(p, c(1, 5)), sort(union(hasse_succ(p, 1), hasse_succ(p, 5))))
+  expect_equal(hasse_pred(p, c(17, 30), intersect = TRUE), sort(intersect(hasse_pred(p, 17), hasse_pred(p, 30))))
+  expect_error(hasse_pred(p, 0))
+
+  # The cache is rebuilt for a saved and restored preference
+  p2 <- unserialize(serialize(p, NULL))
+  expect_equal(hasse_succ(p2, 5), hasse_succ(p, 5))
+  expect_equal(hasse_pred(p2, c(17, 30)), hasse_pred(p, c(17, 30)))
+})
+
 
 # ---------------------------------------------------------------------------
 
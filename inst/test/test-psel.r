@@ -59,7 +59,18 @@ for (parallelity in c(FALSE, TRUE)) {
 
     expect_equal(psel(mtcars, layered(cyl, 3, 4, 8))$cyl, rep(4, 11))
     expect_equal(psel(mtcars, -layered(cyl, c(4, 6), 8))$cyl, rep(8, 14))
+
+    # Layered preferences on factors, with NA values and overlapping layers are like the prior chains of the layers
+    df <- data.frame(f = factor(c("a", "b", "c", "a", NA)), x = c(1, 2, 3, 1, 2))
+    expect_equal(psel(df, layered(f, "c", c("a", "c")), top = 5, show_level = TRUE),
+                 psel(df, true(f %in% "c") & true(f %in% c("a", "c")), top = 5, show_level = TRUE))
+    expect_equal(psel.indices(df, layered(f, c("b", NA), "a") * low(x)), psel.indices(df, (true(f %in% c("b", NA)) & true(f %in% "a")) * low(x)))
+    expect_equal(psel.indices(df, layered(as.character(f), "b", "a") & low(x)), c(2))
     expect_equal(rownames(psel(mtcars, true(mpg < 22) & true(cyl == 4) & true(wt < 3 & gear == 4))), "Volvo 142E")
+
+    # Prior chains of arbitrary base preferences and length
+    expect_equal(psel.indices(mtcars, low(cyl) & high(hp) & -high(wt), top = 5), order(mtcars$cyl, -mtcars$hp, mtcars$wt)[1:5])
+    expect_equal(psel.indices(mtcars, Reduce("&", rep(list(low(mpg), high(hp)), 30))), psel.indices(mtcars, low(mpg) & high(hp)))
   })
 
   test_that("Test if environments are found correctly", {
@@ -141,4 +152,311 @@ for (parallelity in c(FALSE, TRUE)) {
     expect_equal(psel(mtcars, low(mpg), top = 5, top_level = 2, and_connected = FALSE)$.level, c(1, 1, 2, 3, 4))
     expect_equal(psel(mtcars, low(mpg), top = 3, top_level = 5, and_connected = FALSE)$.level, c(1, 1, 2, 3, 4, 5))
   })
+
+  # Progressive preference selection (independent of parallelity)
+  test_that("Test progressive preference selection", {
+    p <- low(mpg) * low(hp)
+    sky <- psel.indices(mtcars, p)
+
+    res <- psel.progressive(mtcars, p, chunk_size = 2)
+    expect_equal(sort(as.vector(res)), sort(sky))
+    expect_true(attr(res, "complete"))
+
+    # Collect chunks via callback
+    chunks <- list()
+    psel.progressive(mtcars, p, chunk_size = 2, callback = function(x) chunks[[length(chunks) + 1]] <<- x)
+    expect_true(all(lengths(chunks) <= 2))
+    expect_equal(sort(unlist(chunks)), sort(sky))
+
+    # Stop after first chunk
+    res <- psel.progressive(mtcars, p, chunk_size = 1, callback = function(x) FALSE)
+    expect_equal(length(res), 1)
+    expect_false(attr(res, "complete"))
+    expect_true(res %in% sky)
+
+    # Union preference (no presorting)
+    expect_equal(sort(as.vector(psel.progressive(mtcars, low(mpg) + low(hp)))), sort(psel.indices(mtcars, low(mpg) + low(hp))))
+  })
+
+  # Results do not depend on the retention of the buffers
+  test_that("Test buffer retention", {
+    p <- low(mpg) * low(hp)
+    sky <- psel.indices(mtcars, p)
+    top <- psel(mtcars, p, top = 10)
+    old <- options(rPref.buffer.retention = 0)
+    expect_equal(psel.indices(mtcars, p), sky)
+    expect_equal(psel(mtcars, p, top = 10), top)
+    options(rPref.buffer.retention = Inf)
+    expect_equal(psel.indices(mtcars, p), sky)
+    options(old)
+  })
+
+  # Evaluation on distinct score vectors gives the same result
+  test_that("Test duplicate collapsing", {
+    df <- data.frame(a = rep(c(1, 2, 3, NA, 2), 20), b = rep(c(3, 2, 1, 1, 2), 20), c = rep(c(-0, 0, 1, 1, 2), 20))
+    p1 <- low(a) * low(b)
+    p2 <- high(c) & low(a) * low(b)
+    sky1 <- sort(psel.indices(df, p1))
+    sky2 <- sort(psel.indices(df, p2))
+    lev1 <- psel(df, p1, top_level = 3, show_level = TRUE)
+    lev2 <- psel(df, low(c), at_least = 30, show_level = TRUE)
+
+    old <- options(rPref.dedup = TRUE)
+    expect_equal(sort(psel.indices(df, p1)), sky1)
+    expect_equal(sort(psel.indices(df, p2)), sky2)
+    res <- psel(df, p1, top_level = 3, show_level = TRUE)
+    expect_equal(res[order(res$.level, as.numeric(rownames(res))), ], lev1[order(lev1$.level, as.numeric(rownames(lev1))), ])
+    res <- psel(df, low(c), at_least = 30, show_level = TRUE)
+    expect_equal(sort(as.numeric(rownames(res))), sort(as.numeric(rownames(lev2))))
+    expect_equal(nrow(psel(df, p1, top = 7)), 7)
+    options(old)
+  })
+
+  # Bitmap Skyline gives the same results as BNL/Scalagon
+  test_that("Test bitmap skyline", {
+    p1 <- low(cyl) * high(gear) * high(am)
+    p2 <- low(cyl) | high(carb)
+    sky1 <- sort(psel.indices(mtcars, p1))
+    sky2 <- sort(psel.indices(mtcars, p2))
+    sky3 <- psel.indices(mtcars, low(cyl) & low(hp))
+    lev <- psel(mtcars, p1, top_level = 3, show_level = TRUE)
+
+    old <- options(rPref.bitmap = TRUE)
+    expect_equal(sort(psel.indices(mtcars, p1)), sky1)
+    expect_equal(sort(psel.indices(mtcars, p2)), sky2)
+    res <- psel(mtcars, p1, top_level = 3, show_level = TRUE)
+    expect_equal(res[rownames(lev), ], lev)
+    # Prioritization is not suited, usual algorithms are used
+    expect_equal(psel.indices(mtcars, low(cyl) & low(hp)), sky3)
+    options(old)
+  })
+
+  # Asynchronous preference selection gives the same results
+  test_that("Test asynchronous preference selection", {
+    p <- low(mpg) * low(hp)
+    job1 <- psel.async(mtcars, p)
+    job2 <- psel.indices.async(mtcars, p, top_level = 2, show_level = TRUE)
+    job3 <- psel.async(mtcars, p, top = 5)
+    expect_true(psel.wait(job1))
+    expect_equal(psel.result(job1)[order(rownames(psel.result(job1))), ], {
+      res <- psel(mtcars, p)
+      res[order(rownames(res)), ]
+    })
+    res <- psel.result(job2)
+    expect_equal(res[order(res$.index), ], {
+      res <- psel.indices(mtcars, p, top_level = 2, show_level = TRUE)
+      res[order(res$.index), ]
+    }, check.attributes = FALSE)
+    expect_equal(nrow(psel.result(job3)), 5)
+    expect_true(psel.poll(job3))
+
+    # Cancelled job has no result
+    job <- psel.async(mtcars, p)
+    psel.cancel(job)
+    psel.wait(job)
+    expect_error(psel.result(job))
+    expect_error(psel.async(dplyr::group_by(mtcars, cyl), p))
+  })
+
+  # Estimation is exact for small data sets and contains the actual size for samples
+  test_that("Test estimation of the result size", {
+    p <- low(mpg) * low(hp)
+    est <- psel.estimate(mtcars, p, levels = 3)
+    expect_true(attr(est, "exact"))
+    expect_equal(est$estimate, as.numeric(table(psel(mtcars, p, top_level = 3)$.level)))
+
+    set.seed(1)
+    df <- data.frame(x = runif(20000), y = runif(20000), z = runif(20000))
+    p <- low(x) * low(y) * low(z)
+    est <- psel.estimate(df, p, levels = 2, sample_size = 2000, conf_level = 0.999)
+    expect_false(attr(est, "exact"))
+    sizes <- as.numeric(table(psel(df, p, top_level = 2)$.level))
+    expect_true(all(est$lower <= sizes & sizes <= est$upper))
+
+    # The levels are calculated from at most max_dominators dominators (lower bounds for the other tuples)
+    df <- data.frame(x = 1:300, y = 1:300)
+    est <- psel.estimate(df, low(x) * low(y), levels = 300, max_dominators = 20)
+    expect_false(attr(est, "exact"))
+    expect_equal(est$estimate[1:21], c(rep(1, 20), 280))
+    expect_equal(sum(est$estimate[22:300]), 0)
+    expect_true(all(est$lower <= 1 & 1 <= est$upper))
+    expect_error(psel.estimate(mtcars, low(mpg), levels = 0))
+  })
+
+  # Cached results are identical, the least recently used result is removed
+  test_that("Test result cache", {
+    old <- options(rPref.cache.size = 2)
+    psel.cache.clear()
+    p <- low(mpg) * low(hp)
+    res1 <- psel(mtcars, p)
+    expect_equal(psel(mtcars, p), res1)
+    expect_equal(psel.cache.stats()[c("hits", "misses", "entries")], list(hits = 1, misses = 1, entries = 1))
+
+    res2 <- psel.indices(mtcars, p, top = 5, show_level = TRUE)
+    expect_equal(psel.indices(mtcars, p, top = 5, show_level = TRUE), res2)
+    expect_equal(psel.indices(mtcars, p, top = 6), psel.indices(mtcars, p, top = 6))
+    expect_equal(psel.cache.stats()$entries, 2)
+
+    # Changed data
+    df <- mtcars
+    df$mpg[1] <- 1
+    expect_true(1 %in% psel.indices(df, p))
+    expect_equal(psel.cache.stats()$hits, 3)
+
+    # Changed options of the evaluation
+    old_dedup <- options(rPref.dedup = TRUE)
+    psel.indices(mtcars, p, top = 5, show_level = TRUE)
+    expect_equal(psel.cache.stats()$hits, 3)
+    options(old_dedup)
+
+    psel.cache.clear()
+    expect_equal(psel.cache.stats()$entries, 0)
+    options(old)
+  })
+
+  # Sliding window gives the maxima of the latest tuples
+  test_that("Test sliding window skyline", {
+    set.seed(1)
+    df <- data.frame(x = sample(20, 300, replace = TRUE), y = sample(20, 300, replace = TRUE), t = cumsum(runif(300)))
+    p <- low(x) * low(y)
+    win1 <- psel.window(p, size = 50)
+    win2 <- psel.window(p, duration = 30)
+    for (i in 1:10) {
+      rows <- (30 * i - 29):(30 * i)
+      psel.window.push(win1, df[rows, ])
+      psel.window.push(win2, df[rows, ], time = df$t[rows])
+      last <- max(rows)
+      expect_equal(psel.window.get(win1, show_index = TRUE)$.index, sort(max(1, last - 49) - 1 + psel.indices(df[max(1, last - 49):last, ], p)))
+      in_time <- which(seq_len(300) <= last & df$t > df$t[last] - 30)
+      expect_equal(psel.window.get(win2, show_index = TRUE)$.index, sort(in_time[psel.indices(df[in_time, ], p)]))
+    }
+    expect_null(psel.window.get(psel.window(p, size = 10)))
+    expect_error(psel.window.push(win2, df[1, ]))
+    expect_error(psel.window(p))
+  })
+
+  # Dynamic Skylines are the maxima of around preferences
+  test_that("Test dynamic skyline", {
+    queries <- data.frame(mpg = c(20, 25, 15), hp = c(100, 150, 200))
+    idx <- psel.dynamic.index(mtcars, c("mpg", "hp"))
+    res <- psel.dynamic(idx, queries)
+    expect_equal(length(res), 3)
+    for (i in 1:3) {
+      expect_equal(res[[i]], sort(psel.indices(mtcars, around(mpg, queries$mpg[i]) * around(hp, queries$hp[i]))))
+    }
+    expect_equal(psel.dynamic(mtcars, queries), res)
+    expect_equal(sort(psel.indices(mtcars, between(hp, 100, 150) * low(mpg))),
+                 sort(psel.indices(mtcars, low(pmax(100 - hp, 0, hp - 150)) * low(mpg))))
+    expect_error(psel.dynamic(idx, queries[2:1]))
+  })
+
+  # k-skyband with exact dominance counts
+  test_that("Test k-skyband", {
+    set.seed(1)
+    df <- data.frame(x = sample(20, 500, replace = TRUE), y = sample(20, 500, replace = TRUE))
+    domcount <- vapply(seq_len(nrow(df)), function(i) sum(df$x <= df$x[i] & df$y <= df$y[i] & (df$x < df$x[i] | df$y < df$y[i])), 0)
+    for (k in c(1, 3, 10)) {
+      res <- psel.skyband(df, low(x) * low(y), k = k)
+      expect_equal(res$.index, which(domcount < k))
+      expect_equal(res$.domcount, domcount[domcount < k])
+    }
+    expect_equal(psel.skyband(mtcars, low(mpg) * high(hp))$.index, sort(psel.indices(mtcars, low(mpg) * high(hp))))
+    expect_error(psel.skyband(df, low(x), k = 0))
+  })
+
+  # Skyline join gives the maxima of the full join
+  test_that("Test skyline join", {
+    set.seed(1)
+    x <- data.frame(k = sample(10, 300, replace = TRUE), a = sample(20, 300, replace = TRUE), b = runif(300))
+    y <- data.frame(key = sample(12, 200, replace = TRUE), c = sample(20, 200, replace = TRUE), b = runif(200))
+    joined <- dplyr::inner_join(x, y, by = c("k" = "key"))
+    sort_rows <- function(df) df[do.call(order, df), , drop = FALSE]
+    for (p in list(low(a) * high(c), low(a) * low(b.x) * high(c), low(a + c) * low(k), low(a) & high(c),
+                   low(abs(a - mean(a))) * high(c), low(pmin(a, 10) * 2) * high(c))) {
+      expect_equal(sort_rows(as.data.frame(psel.join(x, y, p, by = c("k" = "key")))),
+                   sort_rows(as.data.frame(psel(joined, p))), check.attributes = FALSE)
+    }
+    expect_error(psel.join(x, y, low(a), by = "k"))
+  })
+
+  # R-tree queries give the same levels as the preference selection
+  test_that("Test R-tree index", {
+    set.seed(1)
+    df <- data.frame(a = sample(50, 2000, replace = TRUE), b = runif(2000), c = sample(10, 2000, replace = TRUE))
+    idx <- psel.rtree.index(df, c("a", "b", "c"))
+    for (p in list(low(a) * high(b), low(a) * -low(b) * high(c), high(c), low(c) * high(a))) {
+      for (l in 1:3) {
+        res <- psel.rtree(idx, p, top_level = l, show_level = TRUE)
+        exp <- psel.indices(df, p, top_level = l, show_level = TRUE)
+        exp <- exp[order(exp$.level, exp$.index), ]
+        expect_equal(res, exp, check.attributes = FALSE)
+      }
+    }
+    expect_equal(psel.rtree(idx, low(a) * low(b)), sort(psel.indices(df, low(a) * low(b))))
+    expect_error(psel.rtree(idx, low(a + b)))
+    expect_error(psel.rtree(idx, low(a) & low(b)))
+
+    # Equal sums by rounding, the dominator comes first
+    idx <- psel.rtree.index(data.frame(a = c(1e16, 1e16), b = c(1, 0)), c("a", "b"))
+    expect_equal(psel.rtree(idx, low(a) * low(b)), 2)
+    expect_error(psel.rtree.index(data.frame(a = c(1, Inf)), "a"))
+  })
+
+  # Skycube lookups give the Skylines of the subspaces
+  test_that("Test skycube", {
+    set.seed(1)
+    df <- data.frame(a = sample(10, 500, replace = TRUE), b = sample(10, 500, replace = TRUE), c = runif(500))
+    for (compress in c(FALSE, TRUE)) {
+      cube <- psel.skycube(df, c("a", "b", "c"), directions = c("both", "low", "high"), compress = compress)
+      expect_equal(cube$subspaces, 11)
+      for (p in list(low(a), high(a) * low(b), low(a) * low(b) * high(c), low(b) * -low(c), high(c))) {
+        expect_equal(psel.skycube.get(cube, p), sort(psel.indices(df, p)))
+      }
+    }
+    expect_error(psel.skycube.get(cube, high(b)))
+    expect_error(psel.skycube.get(cube, low(a) * high(a)))
+  })
+
+  # Every tuple is epsilon-dominated by a tuple of the approximate Skyline
+  test_that("Test epsilon skyline", {
+    set.seed(1)
+    df <- data.frame(x = runif(2000), z = runif(2000, 1, 100))
+    df$y <- df$x + runif(2000, 0, 0.01)
+    sky <- psel.indices(df, low(x) * high(y))
+    res <- psel.indices(df, low(x) * high(y), epsilon = 0.1)
+    expect_true(length(res) < length(sky))
+    expect_true(all(vapply(seq_len(nrow(df)), function(i) any(df$x[res] <= df$x[i] + 0.1 & df$y[res] >= df$y[i] - 0.1), TRUE)))
+    res <- psel.indices(df, low(x) * low(z), epsilon = c(0.1, 0.2), epsilon_relative = TRUE)
+    expect_true(all(vapply(seq_len(nrow(df)), function(i) any(df$x[res] <= df$x[i] * 1.1 & df$z[res] <= df$z[i] * 1.2), TRUE)))
+    # Small relative epsilon values on extreme values (positive and negative ones)
+    expect_equal(psel.indices(data.frame(x = c(1e-300, -1e-300, 1e300)), low(x), epsilon = 1e-12, epsilon_relative = TRUE), 2)
+    expect_equal(sort(psel.indices(mtcars, low(mpg) * high(hp), epsilon = 0)), sort(psel.indices(mtcars, low(mpg) * high(hp))))
+    expect_error(psel(df, low(x) * low(y), epsilon = -1))
+    expect_error(psel(df, low(x) & low(y), epsilon = 1))
+    expect_error(psel(df, low(x) * low(y), epsilon = 1, top = 3))
+  })
+
+  # Representative maxima are distinct maxima spread over the Skyline
+  test_that("Test representative skyline", {
+    set.seed(1)
+    df <- data.frame(x = runif(3000))
+    df$y <- 1 - df$x + runif(3000, 0, 0.01)
+    sky <- psel.indices(df, low(x) * low(y))
+    res <- psel.indices(df, low(x) * low(y), representative = 10)
+    expect_equal(length(res), 10)
+    expect_true(all(res %in% sky) && !anyDuplicated(res))
+    expect_true(diff(range(df$x[res])) > 0.9)
+    expect_equal(psel.indices(df, low(x) * low(y), representative = 5), res[1:5])
+    expect_equal(sort(psel.indices(mtcars, low(mpg) * high(hp), representative = 100)), sort(psel.indices(mtcars, low(mpg) * high(hp))))
+    expect_equal(length(psel.indices(df, low(x) * low(y), epsilon = 0.01, representative = 3)), 3)
+    # Distances of around are used, not the raw values
+    df2 <- data.frame(x = runif(1000), y = runif(1000))
+    sky2 <- psel.indices(df2, around(x, 0.5) * low(y))
+    vals <- apply(cbind(abs(df2$x[sky2] - 0.5), df2$y[sky2]), 2, function(v) (v - min(v)) / (max(v) - min(v)))
+    sel <- which.max(colSums((t(vals) - colMeans(vals))^2))
+    for (i in 2:3) sel <- c(sel, which.max(apply(vals, 1, function(r) min(colSums((t(vals[sel, , drop = FALSE]) - r)^2)))))
+    expect_equal(psel.indices(df2, around(x, 0.5) * low(y), representative = 3), sky2[sel])
+    expect_error(psel(df, low(x) * low(y), representative = 0))
+    expect_error(psel(df, low(x) * low(y), representative = 3, top = 3))
+  })
 }
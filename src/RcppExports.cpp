@@ -10,6 +10,53 @@ Rcpp::Rostream<true>&  Rcpp::Rcout = Rcpp::Rcpp_cout_get();
 Rcpp::Rostream<false>& Rcpp::Rcerr = Rcpp::Rcpp_cerr_get();
 #endif
 
+// set_buffer_retention_impl
+void set_buffer_retention_impl(double retention_mb);
+RcppExport SEXP _rPref_set_buffer_retention_impl(SEXP retention_mbSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< double >::type retention_mb(retention_mbSEXP);
+    set_buffer_retention_impl(retention_mb);
+    return R_NilValue;
+END_RCPP
+}
+// dynamic_index_impl
+SEXP dynamic_index_impl(const DataFrame& raw);
+RcppExport SEXP _rPref_dynamic_index_impl(SEXP rawSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const DataFrame& >::type raw(rawSEXP);
+    rcpp_result_gen = Rcpp::wrap(dynamic_index_impl(raw));
+    return rcpp_result_gen;
+END_RCPP
+}
+// dynamic_skyline_impl
+List dynamic_skyline_impl(SEXP index, const NumericMatrix& queries, double alpha, int N);
+RcppExport SEXP _rPref_dynamic_skyline_impl(SEXP indexSEXP, SEXP queriesSEXP, SEXP alphaSEXP, SEXP NSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< const NumericMatrix& >::type queries(queriesSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< int >::type N(NSEXP);
+    rcpp_result_gen = Rcpp::wrap(dynamic_skyline_impl(index, queries, alpha, N));
+    return rcpp_result_gen;
+END_RCPP
+}
+// get_fingerprint_impl
+std::string get_fingerprint_impl(const DataFrame& scores, const std::string& str);
+RcppExport SEXP _rPref_get_fingerprint_impl(SEXP scoresSEXP, SEXP strSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const DataFrame& >::type scores(scoresSEXP);
+    Rcpp::traits::input_parameter< const std::string& >::type str(strSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_fingerprint_impl(scores, str));
+    return rcpp_result_gen;
+END_RCPP
+}
 // get_hasse_impl
 NumericVector get_hasse_impl(const DataFrame& scores, List serial_pref);
 RcppExport SEXP _rPref_get_hasse_impl(SEXP scoresSEXP, SEXP serial_prefSEXP) {
@@ -22,9 +69,133 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// get_predsucc_impl
+NumericVector get_predsucc_impl(const DataFrame& scores, List serial_pref, const NumericVector& inds, bool do_intersect, bool succ, int N);
+RcppExport SEXP _rPref_get_predsucc_impl(SEXP scoresSEXP, SEXP serial_prefSEXP, SEXP indsSEXP, SEXP do_intersectSEXP, SEXP succSEXP, SEXP NSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const DataFrame& >::type scores(scoresSEXP);
+    Rcpp::traits::input_parameter< List >::type serial_pref(serial_prefSEXP);
+    Rcpp::traits::input_parameter< const NumericVector& >::type inds(indsSEXP);
+    Rcpp::traits::input_parameter< bool >::type do_intersect(do_intersectSEXP);
+    Rcpp::traits::input_parameter< bool >::type succ(succSEXP);
+    Rcpp::traits::input_parameter< int >::type N(NSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_predsucc_impl(scores, serial_pref, inds, do_intersect, succ, N));
+    return rcpp_result_gen;
+END_RCPP
+}
+// get_hasse_cache_impl
+SEXP get_hasse_cache_impl(const DataFrame& scores, List serial_pref);
+RcppExport SEXP _rPref_get_hasse_cache_impl(SEXP scoresSEXP, SEXP serial_prefSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const DataFrame& >::type scores(scoresSEXP);
+    Rcpp::traits::input_parameter< List >::type serial_pref(serial_prefSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_hasse_cache_impl(scores, serial_pref));
+    return rcpp_result_gen;
+END_RCPP
+}
+// get_hasse_predsucc_impl
+NumericVector get_hasse_predsucc_impl(SEXP cache, const NumericVector& inds, bool do_intersect, bool succ);
+RcppExport SEXP _rPref_get_hasse_predsucc_impl(SEXP cacheSEXP, SEXP indsSEXP, SEXP do_intersectSEXP, SEXP succSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cache(cacheSEXP);
+    Rcpp::traits::input_parameter< const NumericVector& >::type inds(indsSEXP);
+    Rcpp::traits::input_parameter< bool >::type do_intersect(do_intersectSEXP);
+    Rcpp::traits::input_parameter< bool >::type succ(succSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_hasse_predsucc_impl(cache, inds, do_intersect, succ));
+    return rcpp_result_gen;
+END_RCPP
+}
+// psel_async_impl
+SEXP psel_async_impl(const DataFrame& scores, const List& serial_pref, double alpha, bool is_top, int top, int at_least, int toplevel, bool and_connected, bool show_levels, bool use_dedup, bool use_bitmap);
+RcppExport SEXP _rPref_psel_async_impl(SEXP scoresSEXP, SEXP serial_prefSEXP, SEXP alphaSEXP, SEXP is_topSEXP, SEXP topSEXP, SEXP at_leastSEXP, SEXP toplevelSEXP, SEXP and_connectedSEXP, SEXP show_levelsSEXP, SEXP use_dedupSEXP, SEXP use_bitmapSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const DataFrame& >::type scores(scoresSEXP);
+    Rcpp::traits::input_parameter< const List& >::type serial_pref(serial_prefSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< bool >::type is_top(is_topSEXP);
+    Rcpp::traits::input_parameter< int >::type top(topSEXP);
+    Rcpp::traits::input_parameter< int >::type at_least(at_leastSEXP);
+    Rcpp::traits::input_parameter< int >::type toplevel(toplevelSEXP);
+    Rcpp::traits::input_parameter< bool >::type and_connected(and_connectedSEXP);
+    Rcpp::traits::input_parameter< bool >::type show_levels(show_levelsSEXP);
+    Rcpp::traits::input_parameter< bool >::type use_dedup(use_dedupSEXP);
+    Rcpp::traits::input_parameter< bool >::type use_bitmap(use_bitmapSEXP);
+    rcpp_result_gen = Rcpp::wrap(psel_async_impl(scores, serial_pref, alpha, is_top, top, at_least, toplevel, and_connected, show_levels, use_dedup, use_bitmap));
+    return rcpp_result_gen;
+END_RCPP
+}
+// psel_async_poll_impl
+bool psel_async_poll_impl(SEXP job);
+RcppExport SEXP _rPref_psel_async_poll_impl(SEXP jobSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type job(jobSEXP);
+    rcpp_result_gen = Rcpp::wrap(psel_async_poll_impl(job));
+    return rcpp_result_gen;
+END_RCPP
+}
+// psel_async_wait_impl
+bool psel_async_wait_impl(SEXP job, double timeout);
+RcppExport SEXP _rPref_psel_async_wait_impl(SEXP jobSEXP, SEXP timeoutSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type job(jobSEXP);
+    Rcpp::traits::input_parameter< double >::type timeout(timeoutSEXP);
+    rcpp_result_gen = Rcpp::wrap(psel_async_wait_impl(job, timeout));
+    return rcpp_result_gen;
+END_RCPP
+}
+// psel_async_cancel_impl
+void psel_async_cancel_impl(SEXP job);
+RcppExport SEXP _rPref_psel_async_cancel_impl(SEXP jobSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type job(jobSEXP);
+    psel_async_cancel_impl(job);
+    return R_NilValue;
+END_RCPP
+}
+// psel_async_result_impl
+DataFrame psel_async_result_impl(SEXP job);
+RcppExport SEXP _rPref_psel_async_result_impl(SEXP jobSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type job(jobSEXP);
+    rcpp_result_gen = Rcpp::wrap(psel_async_result_impl(job));
+    return rcpp_result_gen;
+END_RCPP
+}
+// psel_estimate_impl
+DataFrame psel_estimate_impl(const DataFrame& scores, List serial_pref, int sample_size, int maxlevel, int max_dom, double alpha, int N);
+RcppExport SEXP _rPref_psel_estimate_impl(SEXP scoresSEXP, SEXP serial_prefSEXP, SEXP sample_sizeSEXP, SEXP maxlevelSEXP, SEXP max_domSEXP, SEXP alphaSEXP, SEXP NSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const DataFrame& >::type scores(scoresSEXP);
+    Rcpp::traits::input_parameter< List >::type serial_pref(serial_prefSEXP);
+    Rcpp::traits::input_parameter< int >::type sample_size(sample_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type maxlevel(maxlevelSEXP);
+    Rcpp::traits::input_parameter< int >::type max_dom(max_domSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< int >::type N(NSEXP);
+    rcpp_result_gen = Rcpp::wrap(psel_estimate_impl(scores, serial_pref, sample_size, maxlevel, max_dom, alpha, N));
+    return rcpp_result_gen;
+END_RCPP
+}
 // pref_select_top_impl
-DataFrame pref_select_top_impl(const DataFrame& scores, const List& serial_pref, int N, double alpha, int top, int at_least, int toplevel, bool and_connected, bool show_levels);
-RcppExport SEXP _rPref_pref_select_top_impl(SEXP scoresSEXP, SEXP serial_prefSEXP, SEXP NSEXP, SEXP alphaSEXP, SEXP topSEXP, SEXP at_leastSEXP, SEXP toplevelSEXP, SEXP and_connectedSEXP, SEXP show_levelsSEXP) {
+DataFrame pref_select_top_impl(const DataFrame& scores, const List& serial_pref, int N, double alpha, int top, int at_least, int toplevel, bool and_connected, bool show_levels, bool use_dedup, bool use_bitmap);
+RcppExport SEXP _rPref_pref_select_top_impl(SEXP scoresSEXP, SEXP serial_prefSEXP, SEXP NSEXP, SEXP alphaSEXP, SEXP topSEXP, SEXP at_leastSEXP, SEXP toplevelSEXP, SEXP and_connectedSEXP, SEXP show_levelsSEXP, SEXP use_dedupSEXP, SEXP use_bitmapSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -37,7 +208,9 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< int >::type toplevel(toplevelSEXP);
     Rcpp::traits::input_parameter< bool >::type and_connected(and_connectedSEXP);
     Rcpp::traits::input_parameter< bool >::type show_levels(show_levelsSEXP);
-    rcpp_result_gen = Rcpp::wrap(pref_select_top_impl(scores, serial_pref, N, alpha, top, at_least, toplevel, and_connected, show_levels));
+    Rcpp::traits::input_parameter< bool >::type use_dedup(use_dedupSEXP);
+    Rcpp::traits::input_parameter< bool >::type use_bitmap(use_bitmapSEXP);
+    rcpp_result_gen = Rcpp::wrap(pref_select_top_impl(scores, serial_pref, N, alpha, top, at_least, toplevel, and_connected, show_levels, use_dedup, use_bitmap));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -62,8 +235,8 @@ BEGIN_RCPP
 END_RCPP
 }
 // pref_select_impl
-NumericVector pref_select_impl(const DataFrame& scores, const List& serial_pref, int N, double alpha);
-RcppExport SEXP _rPref_pref_select_impl(SEXP scoresSEXP, SEXP serial_prefSEXP, SEXP NSEXP, SEXP alphaSEXP) {
+NumericVector pref_select_impl(const DataFrame& scores, const List& serial_pref, int N, double alpha, bool use_dedup, bool use_bitmap);
+RcppExport SEXP _rPref_pref_select_impl(SEXP scoresSEXP, SEXP serial_prefSEXP, SEXP NSEXP, SEXP alphaSEXP, SEXP use_dedupSEXP, SEXP use_bitmapSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -71,7 +244,9 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const List& >::type serial_pref(serial_prefSEXP);
     Rcpp::traits::input_parameter< int >::type N(NSEXP);
     Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
-    rcpp_result_gen = Rcpp::wrap(pref_select_impl(scores, serial_pref, N, alpha));
+    Rcpp::traits::input_parameter< bool >::type use_dedup(use_dedupSEXP);
+    Rcpp::traits::input_parameter< bool >::type use_bitmap(use_bitmapSEXP);
+    rcpp_result_gen = Rcpp::wrap(pref_select_impl(scores, serial_pref, N, alpha, use_dedup, use_bitmap));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -90,13 +265,187 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// pref_select_eps_impl
+NumericVector pref_select_eps_impl(const DataFrame& scores, const List& serial_pref, const NumericVector& eps, bool relative, int N, double alpha);
+RcppExport SEXP _rPref_pref_select_eps_impl(SEXP scoresSEXP, SEXP serial_prefSEXP, SEXP epsSEXP, SEXP relativeSEXP, SEXP NSEXP, SEXP alphaSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const DataFrame& >::type scores(scoresSEXP);
+    Rcpp::traits::input_parameter< const List& >::type serial_pref(serial_prefSEXP);
+    Rcpp::traits::input_parameter< const NumericVector& >::type eps(epsSEXP);
+    Rcpp::traits::input_parameter< bool >::type relative(relativeSEXP);
+    Rcpp::traits::input_parameter< int >::type N(NSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    rcpp_result_gen = Rcpp::wrap(pref_select_eps_impl(scores, serial_pref, eps, relative, N, alpha));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pref_select_progressive_impl
+List pref_select_progressive_impl(const DataFrame& scores, const List& serial_pref, double alpha, int chunk_size, double timeout, Nullable<Function> callback);
+RcppExport SEXP _rPref_pref_select_progressive_impl(SEXP scoresSEXP, SEXP serial_prefSEXP, SEXP alphaSEXP, SEXP chunk_sizeSEXP, SEXP timeoutSEXP, SEXP callbackSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const DataFrame& >::type scores(scoresSEXP);
+    Rcpp::traits::input_parameter< const List& >::type serial_pref(serial_prefSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< int >::type chunk_size(chunk_sizeSEXP);
+    Rcpp::traits::input_parameter< double >::type timeout(timeoutSEXP);
+    Rcpp::traits::input_parameter< Nullable<Function> >::type callback(callbackSEXP);
+    rcpp_result_gen = Rcpp::wrap(pref_select_progressive_impl(scores, serial_pref, alpha, chunk_size, timeout, callback));
+    return rcpp_result_gen;
+END_RCPP
+}
+// psel_skyband_impl
+DataFrame psel_skyband_impl(const DataFrame& scores, List serial_pref, int k, double alpha, int N);
+RcppExport SEXP _rPref_psel_skyband_impl(SEXP scoresSEXP, SEXP serial_prefSEXP, SEXP kSEXP, SEXP alphaSEXP, SEXP NSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const DataFrame& >::type scores(scoresSEXP);
+    Rcpp::traits::input_parameter< List >::type serial_pref(serial_prefSEXP);
+    Rcpp::traits::input_parameter< int >::type k(kSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< int >::type N(NSEXP);
+    rcpp_result_gen = Rcpp::wrap(psel_skyband_impl(scores, serial_pref, k, alpha, N));
+    return rcpp_result_gen;
+END_RCPP
+}
+// representative_impl
+NumericVector representative_impl(const DataFrame& scores, const List& serial_pref, const NumericVector& indices, int k);
+RcppExport SEXP _rPref_representative_impl(SEXP scoresSEXP, SEXP serial_prefSEXP, SEXP indicesSEXP, SEXP kSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const DataFrame& >::type scores(scoresSEXP);
+    Rcpp::traits::input_parameter< const List& >::type serial_pref(serial_prefSEXP);
+    Rcpp::traits::input_parameter< const NumericVector& >::type indices(indicesSEXP);
+    Rcpp::traits::input_parameter< int >::type k(kSEXP);
+    rcpp_result_gen = Rcpp::wrap(representative_impl(scores, serial_pref, indices, k));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rtree_index_impl
+SEXP rtree_index_impl(const DataFrame& raw);
+RcppExport SEXP _rPref_rtree_index_impl(SEXP rawSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const DataFrame& >::type raw(rawSEXP);
+    rcpp_result_gen = Rcpp::wrap(rtree_index_impl(raw));
+    return rcpp_result_gen;
+END_RCPP
+}
+// rtree_skyline_impl
+DataFrame rtree_skyline_impl(SEXP index, const IntegerVector& dims, const IntegerVector& dirs, int top_level);
+RcppExport SEXP _rPref_rtree_skyline_impl(SEXP indexSEXP, SEXP dimsSEXP, SEXP dirsSEXP, SEXP top_levelSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< const IntegerVector& >::type dims(dimsSEXP);
+    Rcpp::traits::input_parameter< const IntegerVector& >::type dirs(dirsSEXP);
+    Rcpp::traits::input_parameter< int >::type top_level(top_levelSEXP);
+    rcpp_result_gen = Rcpp::wrap(rtree_skyline_impl(index, dims, dirs, top_level));
+    return rcpp_result_gen;
+END_RCPP
+}
+// skycube_impl
+SEXP skycube_impl(const DataFrame& raw, const IntegerVector& directions, bool compress, double alpha, int N);
+RcppExport SEXP _rPref_skycube_impl(SEXP rawSEXP, SEXP directionsSEXP, SEXP compressSEXP, SEXP alphaSEXP, SEXP NSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const DataFrame& >::type raw(rawSEXP);
+    Rcpp::traits::input_parameter< const IntegerVector& >::type directions(directionsSEXP);
+    Rcpp::traits::input_parameter< bool >::type compress(compressSEXP);
+    Rcpp::traits::input_parameter< double >::type alpha(alphaSEXP);
+    Rcpp::traits::input_parameter< int >::type N(NSEXP);
+    rcpp_result_gen = Rcpp::wrap(skycube_impl(raw, directions, compress, alpha, N));
+    return rcpp_result_gen;
+END_RCPP
+}
+// skycube_get_impl
+NumericVector skycube_get_impl(SEXP cube, const IntegerVector& digits);
+RcppExport SEXP _rPref_skycube_get_impl(SEXP cubeSEXP, SEXP digitsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cube(cubeSEXP);
+    Rcpp::traits::input_parameter< const IntegerVector& >::type digits(digitsSEXP);
+    rcpp_result_gen = Rcpp::wrap(skycube_get_impl(cube, digits));
+    return rcpp_result_gen;
+END_RCPP
+}
+// skycube_info_impl
+List skycube_info_impl(SEXP cube);
+RcppExport SEXP _rPref_skycube_info_impl(SEXP cubeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type cube(cubeSEXP);
+    rcpp_result_gen = Rcpp::wrap(skycube_info_impl(cube));
+    return rcpp_result_gen;
+END_RCPP
+}
+// psel_window_impl
+SEXP psel_window_impl(double size, double duration);
+RcppExport SEXP _rPref_psel_window_impl(SEXP sizeSEXP, SEXP durationSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< double >::type size(sizeSEXP);
+    Rcpp::traits::input_parameter< double >::type duration(durationSEXP);
+    rcpp_result_gen = Rcpp::wrap(psel_window_impl(size, duration));
+    return rcpp_result_gen;
+END_RCPP
+}
+// psel_window_push_impl
+List psel_window_push_impl(SEXP window, const DataFrame& scores, List serial_pref, const NumericVector& times);
+RcppExport SEXP _rPref_psel_window_push_impl(SEXP windowSEXP, SEXP scoresSEXP, SEXP serial_prefSEXP, SEXP timesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type window(windowSEXP);
+    Rcpp::traits::input_parameter< const DataFrame& >::type scores(scoresSEXP);
+    Rcpp::traits::input_parameter< List >::type serial_pref(serial_prefSEXP);
+    Rcpp::traits::input_parameter< const NumericVector& >::type times(timesSEXP);
+    rcpp_result_gen = Rcpp::wrap(psel_window_push_impl(window, scores, serial_pref, times));
+    return rcpp_result_gen;
+END_RCPP
+}
 
 static const R_CallMethodDef CallEntries[] = {
+    {"_rPref_set_buffer_retention_impl", (DL_FUNC) &_rPref_set_buffer_retention_impl, 1},
+    {"_rPref_dynamic_index_impl", (DL_FUNC) &_rPref_dynamic_index_impl, 1},
+    {"_rPref_dynamic_skyline_impl", (DL_FUNC) &_rPref_dynamic_skyline_impl, 4},
+    {"_rPref_get_fingerprint_impl", (DL_FUNC) &_rPref_get_fingerprint_impl, 2},
     {"_rPref_get_hasse_impl", (DL_FUNC) &_rPref_get_hasse_impl, 2},
-    {"_rPref_pref_select_top_impl", (DL_FUNC) &_rPref_pref_select_top_impl, 9},
+    {"_rPref_get_predsucc_impl", (DL_FUNC) &_rPref_get_predsucc_impl, 6},
+    {"_rPref_get_hasse_cache_impl", (DL_FUNC) &_rPref_get_hasse_cache_impl, 2},
+    {"_rPref_get_hasse_predsucc_impl", (DL_FUNC) &_rPref_get_hasse_predsucc_impl, 4},
+    {"_rPref_psel_async_impl", (DL_FUNC) &_rPref_psel_async_impl, 11},
+    {"_rPref_psel_async_poll_impl", (DL_FUNC) &_rPref_psel_async_poll_impl, 1},
+    {"_rPref_psel_async_wait_impl", (DL_FUNC) &_rPref_psel_async_wait_impl, 2},
+    {"_rPref_psel_async_cancel_impl", (DL_FUNC) &_rPref_psel_async_cancel_impl, 1},
+    {"_rPref_psel_async_result_impl", (DL_FUNC) &_rPref_psel_async_result_impl, 1},
+    {"_rPref_psel_estimate_impl", (DL_FUNC) &_rPref_psel_estimate_impl, 7},
+    {"_rPref_pref_select_top_impl", (DL_FUNC) &_rPref_pref_select_top_impl, 11},
     {"_rPref_grouped_pref_sel_top_impl", (DL_FUNC) &_rPref_grouped_pref_sel_top_impl, 10},
-    {"_rPref_pref_select_impl", (DL_FUNC) &_rPref_pref_select_impl, 4},
+    {"_rPref_pref_select_impl", (DL_FUNC) &_rPref_pref_select_impl, 6},
     {"_rPref_grouped_pref_sel_impl", (DL_FUNC) &_rPref_grouped_pref_sel_impl, 5},
+    {"_rPref_pref_select_eps_impl", (DL_FUNC) &_rPref_pref_select_eps_impl, 6},
+    {"_rPref_pref_select_progressive_impl", (DL_FUNC) &_rPref_pref_select_progressive_impl, 6},
+    {"_rPref_psel_skyband_impl", (DL_FUNC) &_rPref_psel_skyband_impl, 5},
+    {"_rPref_representative_impl", (DL_FUNC) &_rPref_representative_impl, 4},
+    {"_rPref_rtree_index_impl", (DL_FUNC) &_rPref_rtree_index_impl, 1},
+    {"_rPref_rtree_skyline_impl", (DL_FUNC) &_rPref_rtree_skyline_impl, 4},
+    {"_rPref_skycube_impl", (DL_FUNC) &_rPref_skycube_impl, 5},
+    {"_rPref_skycube_get_impl", (DL_FUNC) &_rPref_skycube_get_impl, 2},
+    {"_rPref_skycube_info_impl", (DL_FUNC) &_rPref_skycube_info_impl, 1},
+    {"_rPref_psel_window_impl", (DL_FUNC) &_rPref_psel_window_impl, 2},
+    {"_rPref_psel_window_push_impl", (DL_FUNC) &_rPref_psel_window_push_impl, 4},
     {NULL, NULL, 0}
 };
 
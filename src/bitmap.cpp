@@ -0,0 +1,217 @@
+#include "bitmap.h"
+
+using namespace Rcpp;
+
+// Worker for the parallel dominance tests, candidates are split in N chunks
+class Bitmap_worker : public RcppParallel::Worker {
+public:
+  const bitmap_skyline& bm;
+  const std::vector<int>& cand;
+  const std::vector<uint64_t>& alive;
+  std::vector<char>& dominated;
+  const std::size_t chunk_size;
+  
+  Bitmap_worker(const bitmap_skyline& bm, const std::vector<int>& cand, const std::vector<uint64_t>& alive,
+                std::vector<char>& dominated, std::size_t chunk_size) : 
+    bm(bm), cand(cand), alive(alive), dominated(dominated), chunk_size(chunk_size) {}
+  
+  void operator()(std::size_t begin, std::size_t end)
+  {
+    for (std::size_t k = begin; k < end; k++) {
+      const std::size_t from = k * chunk_size;
+      const std::size_t to = std::min(cand.size(), from + chunk_size);
+      if (from < to) bm.mark_dominated(cand, alive, dominated, from, to);
+    }
+  }
+};
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
+int bitmap_skyline::add_nodes(const ppref& p, std::vector<std::shared_ptr<leafpref>>& leaves)
+{
+  std::shared_ptr<productpref> pref = std::dynamic_pointer_cast<productpref>(p);
+  
+  if (pref == 0) {
+    std::shared_ptr<leafpref> lpref = std::dynamic_pointer_cast<leafpref>(p);
+    if (lpref == 0) return -1; // not solely pareto/intersection
+    leaves.push_back(lpref);
+    m_nodes.push_back({LEAF, -1, -1, static_cast<int>(leaves.size()) - 1});
+    return m_nodes.size() - 1;
+  }
+  
+  const int left = add_nodes(pref->p1, leaves);
+  if (left == -1) return -1;
+  const int right = add_nodes(pref->p2, leaves);
+  if (right == -1) return -1;
+  const node_kind kind = std::dynamic_pointer_cast<pareto>(p) ? PARETO : INTERSECTION;
+  m_nodes.push_back({kind, left, right, -1});
+  return m_nodes.size() - 1;
+}
+
+bool bitmap_skyline::init(const std::vector<int>& v, const ppref& p)
+{
+  m_nodes.clear();
+  std::vector<std::shared_ptr<leafpref>> leaves;
+  if (add_nodes(p, leaves) == -1) return false;
+  
+  const int ntuples = v.size();
+  const int ndims = leaves.size();
+  m_words = (ntuples + 63) / 64;
+  
+  // Ranks of the values (distinct values are collected in a sorted vector, stop if the domain is too large)
+  m_rank = std::vector<std::vector<uint16_t>>(ndims, std::vector<uint16_t>(ntuples));
+  std::vector<int> domain_size(ndims);
+  std::size_t nwords = 0;
+  for (int k = 0; k < ndims; k++) {
+    std::vector<double> values;
+    for (int i = 0; i < ntuples; i++) {
+      const double val = leaves[k]->value(v[i]);
+      if (std::isnan(val)) return false;
+      auto it = std::lower_bound(values.begin(), values.end(), val);
+      if (it == values.end() || *it != val) {
+        if (static_cast<int>(values.size()) == max_domain) return false;
+        values.insert(it, val);
+      }
+    }
+    for (int i = 0; i < ntuples; i++) {
+      m_rank[k][i] = std::lower_bound(values.begin(), values.end(), leaves[k]->value(v[i])) - values.begin();
+    }
+    domain_size[k] = values.size();
+    nwords += static_cast<std::size_t>(domain_size[k]) * m_words;
+  }
+  if (nwords * sizeof(uint64_t) > max_bytes) return false;
+  
+  // Cumulative bitmaps: rank <= r
+  m_le = std::vector<std::vector<uint64_t>>(ndims);
+  for (int k = 0; k < ndims; k++) {
+    m_le[k] = std::vector<uint64_t>(static_cast<std::size_t>(domain_size[k]) * m_words);
+    for (int i = 0; i < ntuples; i++) m_le[k][m_rank[k][i] * m_words + i / 64] |= uint64_t(1) << (i % 64);
+    for (int r = 1; r < domain_size[k]; r++) {
+      for (int w = 0; w < m_words; w++) m_le[k][r * m_words + w] |= m_le[k][(r - 1) * m_words + w];
+    }
+  }
+  
+  m_v = v;
+  return true;
+}
+
+void bitmap_skyline::eval_word(int nd, int pos, int w, uint64_t& better, uint64_t& eq) const
+{
+  const node& n = m_nodes[nd];
+  if (n.kind == LEAF) {
+    const int r = m_rank[n.dim][pos];
+    const uint64_t ge = m_le[n.dim][r * m_words + w];
+    better = (r > 0) ? m_le[n.dim][(r - 1) * m_words + w] : 0;
+    eq = ge & ~better;
+    return;
+  }
+  uint64_t better1, eq1, better2, eq2;
+  eval_word(n.left, pos, w, better1, eq1);
+  eval_word(n.right, pos, w, better2, eq2);
+  if (n.kind == PARETO) {
+    better = (better1 & (better2 | eq2)) | (better2 & (better1 | eq1));
+  } else {
+    better = better1 & better2;
+  }
+  eq = eq1 & eq2;
+}
+
+void bitmap_skyline::mark_dominated(const std::vector<int>& cand, const std::vector<uint64_t>& alive, std::vector<char>& dominated,
+                                    std::size_t begin, std::size_t end) const
+{
+  // Root is the last node
+  const int root = m_nodes.size() - 1;
+  for (std::size_t i = begin; i < end; i++) {
+    if (interrupt::requested()) break; // result is discarded
+    for (int w = 0; w < m_words; w++) {
+      if (alive[w] == 0) continue;
+      uint64_t better, eq;
+      eval_word(root, cand[i], w, better, eq);
+      if (better & alive[w]) {
+        dominated[i] = true;
+        break;
+      }
+    }
+  }
+}
+
+std::vector<char> bitmap_skyline::get_dominated(const std::vector<int>& cand, const std::vector<uint64_t>& alive, int N) const
+{
+  std::vector<char> dominated(cand.size());
+  if (N == 1) {
+    mark_dominated(cand, alive, dominated, 0, cand.size());
+  } else {
+    const std::size_t chunk_size = (cand.size() + N - 1) / N;
+    Bitmap_worker worker(*this, cand, alive, dominated, chunk_size);
+    interrupt::parallel_for(0, N, worker);
+  }
+  return dominated;
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
+std::vector<int> bitmap_skyline::run(int N)
+{
+  const int ntuples = m_v.size();
+  std::vector<int> cand(ntuples);
+  for (int i = 0; i < ntuples; i++) cand[i] = i;
+  
+  // All tuples are alive
+  std::vector<uint64_t> alive(m_words, ~uint64_t(0));
+  if (ntuples % 64 != 0) alive[m_words - 1] = (uint64_t(1) << (ntuples % 64)) - 1;
+  
+  const std::vector<char> dominated = get_dominated(cand, alive, N);
+  
+  std::vector<int> res;
+  for (int i = 0; i < ntuples; i++) {
+    if (!dominated[i]) res.push_back(m_v[i]);
+  }
+  return res;
+}
+
+flex_vector bitmap_skyline::run_topk(const topk_setting& ts, bool show_levels, int N)
+{
+  const int ntuples = m_v.size();
+  std::vector<int> cand(ntuples);
+  for (int i = 0; i < ntuples; i++) cand[i] = i;
+  
+  std::vector<uint64_t> alive(m_words, ~uint64_t(0));
+  if (ntuples % 64 != 0) alive[m_words - 1] = (uint64_t(1) << (ntuples % 64)) - 1;
+  
+  // Pairs of level and tuple index
+  pair_vector res;
+  
+  int level = 1;
+  while (!cand.empty()) {
+    const std::vector<char> dominated = get_dominated(cand, alive, N);
+    
+    // Remove the current level from the alive tuples
+    std::vector<int> remainder;
+    for (std::size_t i = 0; i < cand.size(); i++) {
+      if (dominated[i]) {
+        remainder.push_back(cand[i]);
+      } else {
+        res.push_back(std::pair<int, int>(level, m_v[cand[i]]));
+        alive[cand[i] / 64] &= ~(uint64_t(1) << (cand[i] % 64));
+      }
+    }
+    
+    if (ts.do_break(level, res.size())) break;
+    std::swap(cand, remainder);
+    level++;
+  }
+  
+  std::vector<int> final_result_vector;
+  pair_vector final_result_pair_vector;
+  
+  if (show_levels) {
+    final_result_pair_vector = res;
+    ts.cut(final_result_pair_vector);
+  } else {
+    final_result_vector.reserve(res.size());
+    for (const std::pair<int, int>& u : res) final_result_vector.push_back(u.second);
+    ts.cut(final_result_vector);
+  }
+  
+  return flex_vector(final_result_vector, final_result_pair_vector);
+}
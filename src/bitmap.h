@@ -0,0 +1,70 @@
+#pragma once
+
+// includes also pref-classes and topk-setting
+#include "bnl.h"
+
+// Bitmap Skyline for small domains
+// --------------------------------
+
+// See "Efficient Progressive Skyline Computation", K.-L. Tan, P.-K. Eng, B.C. Ooi, VLDB 2001.
+//
+// For each dimension and each distinct value r there is a bitmap of all tuples with a value <= r.
+// The set of tuples better than a given tuple is calculated word by word with AND/OR operations along the
+// pareto/intersection tree, and a tuple is dominated if this set contains some (remaining) tuple.
+// The dominance tests of the tuples are independent and can be done in parallel.
+
+class bitmap_skyline
+{
+public:
+  
+  // Maximal number of distinct values per dimension
+  static const int max_domain = 256;
+  
+  // Maximal size of all bitmaps
+  static const std::size_t max_bytes = std::size_t(256) << 20;
+  
+  // Build the bitmaps for the tuples v, returns false if the preference is not solely pareto/intersection
+  // of leaf preferences, if some value is NaN, or the domains/bitmaps are too large
+  bool init(const std::vector<int>& v, const ppref& p);
+  
+  // Maxima (tuple indices) using N threads
+  std::vector<int> run(int N = 1);
+  
+  // Top(-level)-k selection with/without levels, the levels are peeled off using N threads
+  flex_vector run_topk(const topk_setting& ts, bool show_levels, int N = 1);
+  
+  // Set dominated[i] for all candidates cand[i], begin <= i < end, which are dominated by some alive tuple
+  // (candidates and alive tuples are positions in v)
+  void mark_dominated(const std::vector<int>& cand, const std::vector<uint64_t>& alive, std::vector<char>& dominated,
+                      std::size_t begin, std::size_t end) const;
+  
+private:
+  
+  // Pareto/intersection tree, leaves refer to dimensions
+  enum node_kind { LEAF, PARETO, INTERSECTION };
+  struct node
+  {
+    node_kind kind;
+    int left, right; // child nodes
+    int dim;         // dimension of leaf
+  };
+  std::vector<node> m_nodes;
+  
+  // Returns the index of the node for p, -1 if p is not suited
+  int add_nodes(const ppref& p, std::vector<std::shared_ptr<leafpref>>& leaves);
+  
+  std::vector<int> m_v;
+  int m_words = 0; // number of 64 bit words per bitmap
+  
+  // Rank of the value of each tuple (position in v) in each dimension (0 is the best value)
+  std::vector<std::vector<uint16_t>> m_rank;
+  
+  // Bitmaps of the tuples with rank <= r in dimension k, word w is m_le[k][r * m_words + w]
+  std::vector<std::vector<uint64_t>> m_le;
+  
+  // Word w of the sets of tuples better than / equal to the tuple at position pos w.r.t. the subtree of node
+  void eval_word(int nd, int pos, int w, uint64_t& better, uint64_t& eq) const;
+  
+  // Dominance test for all candidates (using N threads)
+  std::vector<char> get_dominated(const std::vector<int>& cand, const std::vector<uint64_t>& alive, int N) const;
+};
@@ -0,0 +1,35 @@
+#include "bnl-arena.h"
+
+#include <cstdint>
+
+using namespace Rcpp;
+
+// Default retention: 1 MB per thread
+std::atomic<std::size_t> bnl_arena::s_retention(1 << 20);
+
+bnl_arena& bnl_arena::get()
+{
+  thread_local bnl_arena arena;
+  arena.window.clear();
+  arena.window_next.clear();
+  return arena;
+}
+
+void bnl_arena::trim()
+{
+  if ((window.capacity() + window_next.capacity()) * sizeof(int) > s_retention) {
+    std::vector<int>().swap(window);
+    std::vector<int>().swap(window_next);
+  }
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
+// Set the maximal size (in MB) of the buffers retained by each thread, Inf means no limit
+
+// [[Rcpp::export]]
+void set_buffer_retention_impl(double retention_mb)
+{
+  if (!std::isfinite(retention_mb)) bnl_arena::set_retention(SIZE_MAX);
+  else bnl_arena::set_retention(static_cast<std::size_t>(std::max(0.0, retention_mb * (1 << 20))));
+}
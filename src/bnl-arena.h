@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Rcpp.h>
+#include <atomic>
+
+// Thread local buffers for BNL
+// ----------------------------
+
+// The windows of BNL are usually much smaller than the input.
+// Instead of reserving the input size for each run, the buffers grow on demand
+// and are reused across partitions, groups and top-k levels of the same thread.
+// Buffers larger than the retention limit are released after each run (idle threads keep at most this size).
+// The limit applies only to the buffers retained between runs, not to the peak memory during a run.
+
+class bnl_arena
+{
+public:
+  
+  std::vector<int> window;
+  std::vector<int> window_next;
+  
+  // Empty buffers of the current thread
+  static bnl_arena& get();
+  
+  // Release the buffers if they exceed the retention limit, called after each run
+  void trim();
+  
+  // Maximal size of the buffers retained per thread between runs in bytes (SIZE_MAX for no limit)
+  static void set_retention(std::size_t bytes) { s_retention = bytes; }
+  
+private:
+  static std::atomic<std::size_t> s_retention;
+};
@@ -5,13 +5,13 @@ std::vector<int> bnl::run(const std::vector<int>& indices, const ppref& p)
   const int ntuples = indices.size();
   if (ntuples == 0) return std::vector<int>();
   
-  std::vector<int> window;
-  std::vector<int> window_next;
-  
-  window.reserve(ntuples);
-  window_next.reserve(ntuples);
+  // Buffers of this thread (growing on demand)
+  bnl_arena& arena = bnl_arena::get();
+  std::vector<int>& window = arena.window;
+  std::vector<int>& window_next = arena.window_next;
   
   for (int u : indices) {
+    if (interrupt::requested()) break; // result is discarded
     
     bool dominated = false;
     for (int v : window) {
@@ -29,7 +29,103 @@ std::vector<int> bnl::run(const std::vector<int>& indices, const ppref& p)
     window_next.clear();
   }
   
-  return window;
+  std::vector<int> res(window.begin(), window.end());
+  arena.trim();
+  return res;
+}
+
+
+// Segmented BNL: one pass over all groups without any setup per group,
+// the window buffers are shared by all groups
+void bnl::run_segmented(const std::vector<int>& indices, const std::vector<int>& offsets, const ppref& p, std::vector<int>& res)
+{
+  bnl_arena& arena = bnl_arena::get();
+  std::vector<int>& window = arena.window;
+  std::vector<int>& window_next = arena.window_next;
+  
+  const int ngroups = static_cast<int>(offsets.size()) - 1;
+  for (int g = 0; g < ngroups; g++) {
+    if (interrupt::requested()) break; // result is discarded
+    
+    const int begin = offsets[g];
+    const int end   = offsets[g + 1];
+    if (end - begin <= 1) { // nothing to compare
+      if (end > begin) res.push_back(indices[begin]);
+      continue;
+    }
+    
+    window.clear();
+    for (int i = begin; i < end; i++) {
+      const int u = indices[i];
+      bool dominated = false;
+      for (int v : window) {
+        if (p->cmp(v, u)) { // v (window element) is better
+          dominated = true;
+          break;
+        } else if (!p->cmp(u, v)) { // u (picked element) is NOT better
+          window_next.push_back(v);
+        }
+      }
+      if (!dominated) {
+        std::swap(window, window_next);
+        window.push_back(u);
+      }
+      window_next.clear();
+    }
+    
+    res += window;
+  }
+  
+  arena.trim();
+}
+
+
+// k-skyband BNL: a tuple is not evicted at the first dominator, but when its dominance count reaches k.
+// All dominators of a tuple in the k-skyband are in the k-skyband themselves, hence they are in the window
+// and the counts of the resulting tuples are exact. A tuple with at least k dominators has at least k dominators
+// in the k-skyband, hence it is evicted.
+pair_vector bnl::run_skyband(const std::vector<int>& indices, const ppref& p, int k)
+{
+  if (indices.empty()) return pair_vector();
+  
+  bnl_arena& arena = bnl_arena::get();
+  std::vector<int>& window = arena.window;
+  std::vector<int>& window_next = arena.window_next;
+  
+  // Dominance counts of the window elements
+  std::vector<int> counts, counts_next;
+  
+  for (int u : indices) {
+    if (interrupt::requested()) break; // result is discarded
+    
+    int count = 0;
+    const int wsize = window.size();
+    for (int i = 0; i < wsize; i++) {
+      const int v = window[i];
+      if (p->cmp(v, u)) { // v (window element) is better
+        count++;
+      } else if (p->cmp(u, v)) { // u (picked element) is better
+        if (counts[i] + 1 >= k) continue;
+        counts[i]++;
+      }
+      window_next.push_back(v);
+      counts_next.push_back(counts[i]);
+    }
+    std::swap(window, window_next);
+    std::swap(counts, counts_next);
+    if (count < k) {
+      window.push_back(u);
+      counts.push_back(count);
+    }
+    window_next.clear();
+    counts_next.clear();
+  }
+  
+  pair_vector res;
+  res.reserve(window.size());
+  for (std::size_t i = 0; i < window.size(); i++) res.push_back(std::pair<int, int>(counts[i], window[i]));
+  arena.trim();
+  return res;
 }
 
 
@@ -38,15 +134,15 @@ std::vector<int> bnl::run(const std::vector<int>& indices, const ppref& p)
 // Standard BNL with remainder, for top(level) k calculation WITHOUT using Scalagon
 std::vector<int> bnl::run_remainder(const std::vector<int>& vec, std::vector<int>& remainder, const ppref& p)
 {
-  const int ntuples = vec.size();
-  if (ntuples == 0) return std::vector<int>();
+  if (vec.empty()) return std::vector<int>();
   
-  std::vector<int> window;
-  std::vector<int> window_next;
-  window.reserve(ntuples);
-  window_next.reserve(ntuples);
+  bnl_arena& arena = bnl_arena::get();
+  std::vector<int>& window = arena.window;
+  std::vector<int>& window_next = arena.window_next;
   
   for (int u : vec) {
+    if (interrupt::requested()) break; // result is discarded
+    
     bool dominated = false;
     for (int v : window) {
       if (p->cmp(v, u)) { // v (window element) is better
@@ -67,7 +163,9 @@ std::vector<int> bnl::run_remainder(const std::vector<int>& vec, std::vector<int
     window_next.clear();
   }
   
-  return window;
+  std::vector<int> res(window.begin(), window.end());
+  arena.trim();
+  return res;
 }
 
 
@@ -87,13 +185,11 @@ pair_vector bnl::add_level(const std::vector<int>& vec, int level)
 // special cases (level=1, no topk) are handled by scalagon!
 std::vector<int> bnl::run_topk(std::vector<int> v, const ppref& p, const topk_setting& ts)
 {
-  const int ntuples = v.size();
   int nres = 0;
   
+  // No reservation, the buffers grow on demand (remainder takes over the buffer of v after the first level)
   std::vector<int> final_result;
   std::vector<int> remainder;
-  final_result.reserve(ntuples);
-  remainder.reserve(ntuples);
   
   int level = 1;
   while (true) {
@@ -116,14 +212,9 @@ std::vector<int> bnl::run_topk(std::vector<int> v, const ppref& p, const topk_se
 // special cases (level=1, no topk) are handled before!
 pair_vector bnl::run_topk_lev(std::vector<int> vec, const ppref& p, const topk_setting& ts)
 {
-  const int ntuples = vec.size();
-  
   std::vector<int> remainder;
   pair_vector final_result;
   
-  final_result.reserve(ntuples);
-  remainder.reserve(ntuples);
-  
   int level = 1;
   while (true) {
     pair_vector res = add_level(run_remainder(vec, remainder, p), level);
@@ -138,43 +229,3 @@ pair_vector bnl::run_topk_lev(std::vector<int> vec, const ppref& p, const topk_s
   ts.cut(final_result);
   return final_result;
 }
-
-
-// --------------------------------------------------------------------------------------------------------------------------------
-
-// BNL for top-k calculation with remainder and additional index std::vector for scalagon
-// add remainder beginnung at remcount
-pair_vector bnl::run_remainder_paired(const pair_vector& index_pairs, pair_vector& remainder_pairs, const ppref& p)
-{
-  const int ntuples = index_pairs.size();
-  if (ntuples == 0) return pair_vector();
-  
-  pair_vector window;
-  pair_vector window_next;
-  window.reserve(ntuples);
-  window_next.reserve(ntuples);
-  
-  for (const std::pair<int,int>& u : index_pairs) {
-    
-    bool dominated = false;
-    for (const std::pair<int,int>& v : window) {
-      if (p->cmp(v.first, u.first)) { // v (window element) is better
-        dominated = true;
-        break;
-      } else if (p->cmp(u.first, v.first)) { // u (picked element) is better
-        remainder_pairs.push_back(v);
-      } else {
-        window_next.push_back(v);
-      }
-    }
-    if (!dominated) {
-      std::swap(window, window_next);
-      window.push_back(u);
-    } else {
-      remainder_pairs.push_back(u);
-    }
-    window_next.clear();
-  }
-
-  return window;
-}
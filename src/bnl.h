@@ -2,6 +2,8 @@
 
 #include "topk-setting.h"
 #include "pref-classes.h"
+#include "interrupt.h"
+#include "bnl-arena.h"
 
 // ----------------------------------------------------------------------------------------------------------------------------------------
 
@@ -14,7 +16,7 @@ std::vector<T>& operator+=(std::vector<T>& vector1, const std::vector<T>& vector
 
 // ----------------------------------------------------------------------------------------------------------------------------------------
 
-// Vector of pairs (for <level, v-index> or for <v-index, s-index>)
+// Vector of pairs (for <level, v-index>)
 using pair_vector = std::vector<std::pair<int, int>>;
 
 // List containing v-indices OR v-indices together with levels
@@ -42,13 +44,13 @@ struct bnl
   // internal BNL variant for BNL top-k
   static std::vector<int> run_remainder(const std::vector<int>& v, std::vector<int>& remainder, const ppref& p);
   
-  // ** BNL for Scalagon
+  // Segmented BNL for many small groups stored contiguously in indices,
+  // group g is [offsets[g], offsets[g+1]), the maxima of all groups are appended to res (in order of the groups)
+  static void run_segmented(const std::vector<int>& indices, const std::vector<int>& offsets, const ppref& p, std::vector<int>& res);
   
-  // Remainder (non-optimal optimal tuples) is added to remainder_pairs,
-  // for each added tuple, remcount is incremented
-  
-  // special top-k BNL variant for Scalagon filtering step
-  static pair_vector run_remainder_paired(const pair_vector& index_pairs, pair_vector& remainder_pairs, const ppref& p);
+  // BNL for the k-skyband: the window keeps the tuples with less than k dominators (so far) together with
+  // their dominance counts, returns <domcount, v-index>
+  static pair_vector run_skyband(const std::vector<int>& indices, const ppref& p, int k);
 
 };
 
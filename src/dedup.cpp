@@ -0,0 +1,124 @@
+#include "dedup.h"
+#include "fingerprint.h"
+
+#include <unordered_map>
+
+using namespace Rcpp;
+
+static inline bool equal_val(double a, double b)
+{
+  return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+bool dedup::init(const DataFrame& scores)
+{
+  std::vector<std::vector<double>> cols(scores.size());
+  for (std::size_t k = 0; k < cols.size(); k++) cols[k] = as<std::vector<double>>(as<NumericVector>(scores[k]));
+  return init(cols);
+}
+
+bool dedup::init(const std::vector<std::vector<double>>& cols)
+{
+  const int ncols = cols.size();
+  const int ntuples = ncols > 0 ? cols[0].size() : 0;
+  
+  auto equal_rows = [&](int i, int j) {
+    for (int k = 0; k < ncols; k++) {
+      if (!equal_val(cols[k][i], cols[k][j])) return false;
+    }
+    return true;
+  };
+  
+  m_reps.clear();
+  m_class = std::vector<int>(ntuples);
+  
+  // First class for each hash value, further classes with the same hash are chained
+  std::unordered_map<uint64_t, int> first_class;
+  first_class.reserve(ntuples);
+  std::vector<int> next_class;
+  
+  for (int i = 0; i < ntuples; i++) {
+    uint64_t h = 0;
+    for (int k = 0; k < ncols; k++) h = h * 31 + hash_val(cols[k][i]);
+    
+    const auto it = first_class.find(h);
+    int c = (it == first_class.end()) ? -1 : it->second;
+    int last = -1;
+    while (c != -1 && !equal_rows(m_reps[c], i)) {
+      last = c;
+      c = next_class[c];
+    }
+    
+    if (c == -1) { // new class
+      c = m_reps.size();
+      m_reps.push_back(i);
+      next_class.push_back(-1);
+      if (last == -1) first_class[h] = c;
+      else            next_class[last] = c;
+    }
+    m_class[i] = c;
+  }
+  
+  const int nclasses = m_reps.size();
+  if (nclasses == ntuples) return false; // no duplicates
+  
+  // Members of each class (counting sort, keeps the order of the tuples)
+  m_offsets = std::vector<int>(nclasses + 1);
+  for (int i = 0; i < ntuples; i++) m_offsets[m_class[i] + 1]++;
+  for (int c = 0; c < nclasses; c++) m_offsets[c + 1] += m_offsets[c];
+  m_members = std::vector<int>(ntuples);
+  std::vector<int> pos(m_offsets.begin(), m_offsets.end() - 1);
+  for (int i = 0; i < ntuples; i++) m_members[pos[m_class[i]]++] = i;
+  
+  return true;
+}
+
+std::vector<int> dedup::expand(const std::vector<int>& reps) const
+{
+  std::vector<int> res;
+  for (int u : reps) {
+    const int c = m_class[u];
+    res.insert(res.end(), m_members.begin() + m_offsets[c], m_members.begin() + m_offsets[c + 1]);
+  }
+  return res;
+}
+
+flex_vector dedup::expand_levels(pair_vector reps, const topk_setting& ts, bool show_levels) const
+{
+  // Pairs of level and tuple index
+  pair_vector res;
+  
+  std::stable_sort(reps.begin(), reps.end(),
+                   [](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.first < b.first; });
+  
+  // The representatives may contain more levels than needed, as each class counts as one tuple
+  std::size_t begin = 0;
+  while (begin < reps.size()) {
+    const int level = reps[begin].first;
+    std::size_t end = begin;
+    std::vector<int> level_reps;
+    for (; end < reps.size() && reps[end].first == level; end++) level_reps.push_back(reps[end].second);
+    
+    // Expand the current level, equivalent tuples are returned in order of the input (like BNL)
+    std::vector<int> level_res = expand(level_reps);
+    std::sort(level_res.begin(), level_res.end());
+    for (int u : level_res) res.push_back(std::pair<int, int>(level, u));
+    
+    if (ts.do_break(level, res.size())) break;
+    begin = end;
+  }
+  
+  std::vector<int> final_result_vector;
+  pair_vector final_result_pair_vector;
+  
+  if (show_levels) {
+    final_result_pair_vector = res;
+    ts.cut(final_result_pair_vector);
+  } else {
+    final_result_vector.reserve(res.size());
+    for (const std::pair<int, int>& u : res) final_result_vector.push_back(u.second);
+    ts.cut(final_result_vector);
+  }
+  
+  return flex_vector(final_result_vector, final_result_pair_vector);
+}
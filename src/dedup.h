@@ -0,0 +1,42 @@
+#pragma once
+
+// includes also pref-classes and topk-setting
+#include "bnl.h"
+
+// Duplicate collapsing
+// --------------------
+
+// Tuples with identical score vectors are equivalent w.r.t. every preference on these scores:
+// They are compared in the same way to all other tuples and are never better than each other.
+// Hence the maxima/levels are calculated for one representative per class of identical score vectors
+// and afterwards expanded to all tuples of the class.
+
+class dedup
+{
+public:
+  
+  // Hash all score rows into classes, returns false if there are no duplicates
+  bool init(const Rcpp::DataFrame& scores);
+  bool init(const std::vector<std::vector<double>>& cols);
+  
+  // First tuple of each class (sorted by tuple index)
+  const std::vector<int>& representatives() const { return m_reps; }
+  
+  // All tuples of the classes of the given representatives
+  std::vector<int> expand(const std::vector<int>& reps) const;
+  
+  // Top(-level)-k selection with/without levels from the levels of the representatives (calculated by any
+  // top-k algorithm with the same setting), the break condition and the cut consider the number of tuples of the classes
+  flex_vector expand_levels(pair_vector reps, const topk_setting& ts, bool show_levels) const;
+  
+private:
+  
+  std::vector<int> m_reps;
+  
+  // Class of each tuple
+  std::vector<int> m_class;
+  
+  // Tuples of class c are m_members[m_offsets[c]], ..., m_members[m_offsets[c + 1] - 1]
+  std::vector<int> m_offsets;
+  std::vector<int> m_members;
+};
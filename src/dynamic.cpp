@@ -0,0 +1,106 @@
+// [[Rcpp::depends(RcppParallel)]]
+#include <RcppParallel.h>
+using namespace RcppParallel;
+
+#include "dynamic.h"
+
+using namespace Rcpp;
+
+dynamic_index::dynamic_index(const std::vector<std::vector<double>>& cols)
+{
+  for (const std::vector<double>& col : cols) m_cols.push_back(std::make_shared<const std::vector<double>>(col));
+  
+  m_has_dups = m_dedup.init(cols);
+  if (m_has_dups) {
+    m_reps = m_dedup.representatives();
+  } else {
+    const int ntuples = cols.empty() ? 0 : cols[0].size();
+    m_reps = std::vector<int>(ntuples);
+    for (int i = 0; i < ntuples; i++) m_reps[i] = i;
+  }
+}
+
+ppref dynamic_index::query_pref(const std::vector<double>& point) const
+{
+  ppref res;
+  for (int k = dim() - 1; k >= 0; k--) {
+    ppref leaf = std::make_shared<distpref>(m_cols[k], point[k], point[k]);
+    res = res ? pareto::make(leaf, res) : leaf;
+  }
+  return res;
+}
+
+std::vector<int> dynamic_index::run(const std::vector<double>& point, scalagon& scal_alg, double alpha) const
+{
+  std::vector<int> res = scal_alg.run(m_reps, query_pref(point), alpha);
+  if (m_has_dups) res = m_dedup.expand(res);
+  std::sort(res.begin(), res.end());
+  return res;
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
+// Dynamic Skylines of many query points in parallel, each query uses its own stream for the samples of Scalagon
+class Dynamic_worker : public Worker {
+public:
+  const dynamic_index& index;
+  const std::vector<std::vector<double>>& points;
+  const double alpha;
+  const uint64_t seed;
+  const int queries_part;
+  std::vector<std::vector<int>> results;
+  
+  Dynamic_worker(const dynamic_index& index, const std::vector<std::vector<double>>& points, double alpha, uint64_t seed,
+                 int queries_part) :
+    index(index), points(points), alpha(alpha), seed(seed), queries_part(queries_part), results(points.size()) {}
+  
+  void operator()(std::size_t begin, std::size_t end)
+  {
+    const int nqueries = points.size();
+    for (std::size_t k = begin; k < end; k++) {
+      const int to = std::min(nqueries, static_cast<int>(k + 1) * queries_part);
+      for (int q = k * queries_part; q < to; q++) {
+        if (interrupt::requested()) return; // result is discarded
+        scalagon scal_alg(sampler(seed, q));
+        results[q] = index.run(points[q], scal_alg, alpha);
+      }
+    }
+  }
+};
+
+// Create the index for dynamic Skylines on the given numeric columns
+// [[Rcpp::export]]
+SEXP dynamic_index_impl(const DataFrame& raw)
+{
+  std::vector<std::vector<double>> cols(raw.size());
+  for (std::size_t k = 0; k < cols.size(); k++) cols[k] = as<std::vector<double>>(as<NumericVector>(raw[k]));
+  return XPtr<dynamic_index>(new dynamic_index(cols), true);
+}
+
+// Dynamic Skylines (C indices) for the query points (rows of queries, one column per column of the index)
+// [[Rcpp::export]]
+List dynamic_skyline_impl(SEXP index, const NumericMatrix& queries, double alpha, int N)
+{
+  XPtr<dynamic_index> idx(index);
+  if (idx.get() == 0) stop("The index is not available anymore, create a new one!");
+  if (queries.ncol() != idx->dim()) stop("The query points must have one value for each attribute of the index!");
+  
+  const int nqueries = queries.nrow();
+  std::vector<std::vector<double>> points(nqueries, std::vector<double>(idx->dim()));
+  for (int q = 0; q < nqueries; q++) {
+    for (int k = 0; k < idx->dim(); k++) points[q][k] = queries(q, k);
+  }
+  
+  List res(nqueries);
+  if (nqueries == 0) return res;
+  
+  // Actual number of chunks of the queries
+  const int queries_part = std::ceil(1.0 * nqueries / N);
+  const int N_parts = std::ceil(1.0 * nqueries / queries_part);
+  
+  Dynamic_worker worker(*idx, points, alpha, sampler::seed_from_r(), queries_part);
+  interrupt::parallel_for(0, N_parts, worker);
+  
+  for (int q = 0; q < nqueries; q++) res[q] = NumericVector(worker.results[q].begin(), worker.results[q].end());
+  return res;
+}
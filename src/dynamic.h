@@ -0,0 +1,37 @@
+#pragma once
+
+// includes also BNL and pref classes
+#include "scalagon.h"
+#include "dedup.h"
+
+// Dynamic Skyline
+// ---------------
+
+// The dynamic Skyline of a query point q contains the tuples which are not dominated w.r.t. the distances |x_k - q_k|
+// in all dimensions k, i.e., the Pareto preference of around(x_k, q_k). The index keeps the raw values (shared by the
+// distance preferences of all query points) and the classes of identical tuples, which are equivalent for every query point.
+
+class dynamic_index
+{
+public:
+  
+  dynamic_index(const std::vector<std::vector<double>>& cols);
+  
+  int dim() const { return m_cols.size(); }
+  
+  // Pareto preference of the distances to the query point
+  ppref query_pref(const std::vector<double>& point) const;
+  
+  // Dynamic Skyline of the query point (ascending tuple indices), the given Scalagon instance must not be seeded from R
+  // if this is called in a worker thread
+  std::vector<int> run(const std::vector<double>& point, scalagon& scal_alg, double alpha) const;
+  
+private:
+  
+  std::vector<std::shared_ptr<const std::vector<double>>> m_cols;
+  
+  // Representatives of the classes of identical tuples (or all tuples)
+  dedup m_dedup;
+  bool m_has_dups;
+  std::vector<int> m_reps;
+};
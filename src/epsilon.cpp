@@ -0,0 +1,112 @@
+#include "epsilon.h"
+
+#include <unordered_map>
+
+using namespace Rcpp;
+
+bool epsilon_grid::add_leaves(const ppref& p, std::vector<std::shared_ptr<leafpref>>& leaves, std::vector<bool>& reversed)
+{
+  if (std::shared_ptr<pareto> par = std::dynamic_pointer_cast<pareto>(p)) {
+    return add_leaves(par->p1, leaves, reversed) && add_leaves(par->p2, leaves, reversed);
+  }
+
+  bool rev = false;
+  ppref leaf = p;
+  while (std::shared_ptr<reversepref> rpref = std::dynamic_pointer_cast<reversepref>(leaf)) {
+    rev = !rev;
+    leaf = rpref->p;
+  }
+
+  // Ranks of prioritization chains are no values
+  std::shared_ptr<leafpref> lpref = std::dynamic_pointer_cast<leafpref>(leaf);
+  if (lpref == 0 || std::dynamic_pointer_cast<lexpref>(leaf)) return false;
+  leaves.push_back(lpref);
+  reversed.push_back(rev);
+  return true;
+}
+
+// Box numbers are non-decreasing in the value
+double epsilon_grid::box(double val, double eps)
+{
+  if (std::isnan(val) || eps == 0) return val;
+  return std::floor(val / eps);
+}
+
+// Logarithmic box number of the absolute value
+double epsilon_grid::log_box(double val, double eps)
+{
+  return std::floor(std::log(std::fabs(val)) / std::log1p(eps));
+}
+
+// Relative boxes of positive and negative values are separated by the offset, which must be larger than
+// all logarithmic box numbers of finite values
+double epsilon_grid::relative_box(double val, double eps, double offset)
+{
+  if (std::isnan(val) || std::isinf(val) || eps == 0 || val == 0) return val;
+  const double lbox = log_box(val, eps);
+  return (val > 0) ? offset + lbox : -offset - lbox;
+}
+
+bool epsilon_grid::init(const std::vector<int>& v, const ppref& p, const std::vector<double>& eps, bool relative)
+{
+  std::vector<std::shared_ptr<leafpref>> leaves;
+  std::vector<bool> reversed;
+  if (!add_leaves(p, leaves, reversed)) return false;
+
+  const int ndims = leaves.size();
+  if (eps.size() != 1 && static_cast<int>(eps.size()) != ndims) {
+    stop("The number of epsilon values must be 1 or the number of base preferences (" + std::to_string(ndims) + ")!");
+  }
+
+  // Oriented values (smaller is better) and their boxes
+  const int ntuples = leaves[0]->size();
+  m_boxes = std::vector<std::vector<double>>(ndims, std::vector<double>(ntuples));
+  std::vector<double> sum(ntuples);
+  for (int k = 0; k < ndims; k++) {
+    const double eps_k = eps[eps.size() == 1 ? 0 : k];
+    std::vector<double>& boxes = m_boxes[k];
+    double offset = 1;
+    for (int i : v) {
+      const double val = reversed[k] ? -leaves[k]->value(i) : leaves[k]->value(i);
+      boxes[i] = val;
+      sum[i] += std::isnan(val) ? INFINITY : val;
+      if (relative && eps_k != 0 && std::isfinite(val) && val != 0) offset = std::max(offset, 1 + std::fabs(log_box(val, eps_k)));
+    }
+    for (int i : v) boxes[i] = relative ? relative_box(boxes[i], eps_k, offset) : box(boxes[i], eps_k);
+  }
+
+  // Tuple with the smallest sum of values in each box (a maximum within the box)
+  auto hash = [&](int i) {
+    std::size_t h = 0;
+    for (int k = 0; k < ndims; k++) h = h * 1000003 ^ std::hash<double>()(m_boxes[k][i]);
+    return h;
+  };
+  auto equal = [&](int i, int j) {
+    for (int k = 0; k < ndims; k++) {
+      const double a = m_boxes[k][i], b = m_boxes[k][j];
+      if (a != b && !(std::isnan(a) && std::isnan(b))) return false;
+    }
+    return true;
+  };
+  std::unordered_map<int, int, decltype(hash), decltype(equal)> best(v.size(), hash, equal);
+  for (int i : v) {
+    auto it = best.emplace(i, i).first;
+    if (sum[i] < sum[it->second]) it->second = i;
+  }
+
+  m_reps.clear();
+  m_reps.reserve(best.size());
+  for (const std::pair<const int, int>& b : best) m_reps.push_back(b.second);
+  std::sort(m_reps.begin(), m_reps.end());
+  return true;
+}
+
+ppref epsilon_grid::box_pref() const
+{
+  ppref res;
+  for (int k = dim() - 1; k >= 0; k--) {
+    ppref leaf = std::make_shared<scorepref>(std::vector<double>(m_boxes[k]));
+    res = res ? pareto::make(leaf, res) : leaf;
+  }
+  return res;
+}
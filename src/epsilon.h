@@ -0,0 +1,47 @@
+#pragma once
+
+// includes also BNL and pref classes
+#include "scalagon.h"
+
+// epsilon-Skyline
+// ---------------
+
+// Approximate Skyline for Pareto compositions of (possibly reversed) leaf preferences.
+// See "Combining Convergence and Diversity in Evolutionary Multiobjective Optimization",
+// M. Laumanns, L. Thiele, K. Deb, E. Zitzler, Evolutionary Computation 10(3), 2002.
+//
+// Each dimension k is divided into boxes of width eps[k] (absolute), or of width log(1 + eps[k]) on a logarithmic
+// scale of the absolute values (relative). The result contains one tuple (a maximum within its box) of each box
+// which is not dominated by another box. Hence each tuple t is covered by a resulting tuple s, i.e.,
+// s[k] <= t[k] + eps[k] (absolute) or s[k] is within a factor 1 + eps[k] of t[k] (relative) in all dimensions.
+// The boxes are evaluated by BNL/Scalagon on the (small) domains of the box numbers.
+
+class epsilon_grid
+{
+public:
+
+  // Calculate the boxes of the tuples v, returns false if p is not a Pareto composition of (possibly reversed)
+  // leaf preferences or a prioritization chain. eps contains one value for all or one value for each leaf
+  bool init(const std::vector<int>& v, const ppref& p, const std::vector<double>& eps, bool relative);
+
+  // Number of leaves found by init
+  int dim() const { return m_boxes.size(); }
+
+  // Pareto preference on the box numbers (defined on the tuple indices of v)
+  ppref box_pref() const;
+
+  // One tuple of each box (maximum within the box, sorted by tuple index)
+  const std::vector<int>& representatives() const { return m_reps; }
+
+private:
+
+  // Box numbers of all leaves, for all tuple indices (only tuples of v are set)
+  std::vector<std::vector<double>> m_boxes;
+  std::vector<int> m_reps;
+
+  static bool add_leaves(const ppref& p, std::vector<std::shared_ptr<leafpref>>& leaves, std::vector<bool>& reversed);
+
+  static double box(double val, double eps);
+  static double log_box(double val, double eps);
+  static double relative_box(double val, double eps, double offset);
+};
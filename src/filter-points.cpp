@@ -0,0 +1,50 @@
+#include "filter-points.h"
+
+// for bnl::run
+#include "bnl.h"
+
+// Select the maxima of the sample with the highest numbers of dominated sample tuples
+std::vector<int> filter_points::get(std::vector<int> sample, const ppref& p)
+{
+  std::sort(sample.begin(), sample.end());
+  sample.erase(std::unique(sample.begin(), sample.end()), sample.end());
+  
+  // Only maxima of the sample are candidates (a dominated tuple is a worse filter than its dominator)
+  const std::vector<int> candidates = bnl::run(sample, p);
+  
+  // Pairs of (negative) number of dominated sample tuples and tuple index
+  pair_vector dom_counts;
+  dom_counts.reserve(candidates.size());
+  for (int u : candidates) {
+    int count = 0;
+    for (int w : sample) {
+      if (p->cmp(u, w)) count++;
+    }
+    if (count > 0) dom_counts.push_back(std::pair<int, int>(-count, u));
+  }
+  
+  const std::size_t npoints = std::min(dom_counts.size(), static_cast<std::size_t>(max_points));
+  std::partial_sort(dom_counts.begin(), dom_counts.begin() + npoints, dom_counts.end());
+  
+  std::vector<int> res;
+  res.reserve(npoints);
+  for (std::size_t k = 0; k < npoints; k++) res.push_back(dom_counts[k].second);
+  return res;
+}
+
+std::vector<int> filter_points::filter(const std::vector<int>& v, const std::vector<int>& fpoints, const ppref& p)
+{
+  std::vector<int> res;
+  res.reserve(v.size());
+  for (int u : v) {
+    bool dominated = false;
+    for (int f : fpoints) {
+      if (p->cmp(f, u)) {
+        dominated = true;
+        break;
+      }
+    }
+    if (!dominated) res.push_back(u);
+  }
+  return res;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "pref-classes.h"
+
+// Global pruning for the partitioned preference selection
+// -------------------------------------------------------
+
+// A few "filter points" are picked from a global sample: maxima of the sample which dominate most sample tuples.
+// They are given to all workers, which discard tuples dominated by a filter point before the BNL/Scalagon run.
+// As filter points are tuples of the data set, no maximum is discarded.
+
+struct filter_points
+{
+  // Maximal number of filter points (each tuple is compared with all of them)
+  static const int max_points = 16;
+  
+  // Get filter points from the sample (tuple indices, duplicates allowed)
+  static std::vector<int> get(std::vector<int> sample, const ppref& p);
+  
+  // Remove all tuples dominated by some filter point, keeps the order of v
+  static std::vector<int> filter(const std::vector<int>& v, const std::vector<int>& fpoints, const ppref& p);
+};
@@ -0,0 +1,33 @@
+#include "fingerprint.h"
+
+#include <cstdio>
+
+using namespace Rcpp;
+
+// Fingerprint (128 bits) of the score columns together with a string (the serialized preference and the top-k settings),
+// used as index of the result cache in R. The score values are not stored in the cache, hence the fingerprint consists
+// of two independent hashes, such that a collision is very unlikely.
+// Equivalent values (NaN, +0/-0) give the same fingerprint like in dedup.
+// [[Rcpp::export]]
+std::string get_fingerprint_impl(const DataFrame& scores, const std::string& str)
+{
+  const int ncols = scores.size();
+  uint64_t h1 = ncols, h2 = ~static_cast<uint64_t>(ncols);
+  auto add = [&h1, &h2](uint64_t bits) {
+    h1 = (h1 ^ bits) * 0x9e3779b97f4a7c15ULL;
+    h1 ^= h1 >> 32;
+    h2 = (h2 + ((bits << 23) | (bits >> 41))) * 0xd6e8feb86659fd93ULL;
+    h2 ^= h2 >> 29;
+  };
+  
+  for (int k = 0; k < ncols; k++) {
+    const NumericVector col = as<NumericVector>(scores[k]);
+    add(col.size());
+    for (double val : col) add(hash_val(val));
+  }
+  for (char c : str) add(static_cast<unsigned char>(c));
+  
+  char buf[33];
+  std::snprintf(buf, sizeof(buf), "%016llx%016llx", static_cast<unsigned long long>(h1), static_cast<unsigned long long>(h2));
+  return std::string(buf);
+}
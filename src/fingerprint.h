@@ -0,0 +1,22 @@
+#pragma once
+
+#include <Rcpp.h>
+#include <cstdint>
+#include <cstring>
+
+// Hashes of score values
+// ----------------------
+
+// Hash of a value where all NaN values and +0/-0 are equal (like in the comparisons of dedup)
+inline uint64_t hash_val(double val)
+{
+  if (std::isnan(val)) val = NAN;
+  else if (val == 0) val = 0;
+  uint64_t bits;
+  std::memcpy(&bits, &val, sizeof(bits));
+  // mix (from splitmix64)
+  bits ^= bits >> 30;
+  bits *= 0xbf58476d1ce4e5b9ULL;
+  bits ^= bits >> 27;
+  return bits;
+}
@@ -1,4 +1,6 @@
 #include "hasse.h"
+#include "interrupt.h"
+#include "bnl.h"
 
 using namespace Rcpp;
 
@@ -23,6 +25,171 @@ NumericVector get_hasse_impl(const DataFrame& scores, List serial_pref)
 }
 
 
+// All predecessors/successors of a set of tuples
+// -----------------------------------------------
+
+// Worker for the union/intersection of all predecessors/successors of the query tuples.
+// The tuples are split in N chunks of whole 64 bit words, such that each thread writes its own words of the bitset.
+class Predsucc_worker : public RcppParallel::Worker {
+public:
+  const ppref& p;
+  const std::vector<int>& inds;
+  const bool do_intersect;
+  const bool succ;
+  const int ntuples;
+  const int words_part;
+  std::vector<uint64_t>& bits;
+  
+  Predsucc_worker(const ppref& p, const std::vector<int>& inds, bool do_intersect, bool succ, int ntuples, int words_part,
+                  std::vector<uint64_t>& bits) :
+    p(p), inds(inds), do_intersect(do_intersect), succ(succ), ntuples(ntuples), words_part(words_part), bits(bits) {}
+  
+  void operator()(std::size_t begin, std::size_t end)
+  {
+    for (std::size_t k = begin; k < end; k++) {
+      const int from = k * words_part * 64;
+      const int to = std::min(ntuples, static_cast<int>(k + 1) * words_part * 64);
+      for (int j = from; j < to; j++) {
+        if ((j % 64 == 0) && interrupt::requested()) return; // result is discarded
+        // Union: some query tuple is better/worse, intersection: all query tuples are better/worse
+        bool found = do_intersect;
+        for (int i : inds) {
+          const bool rel = succ ? p->cmp(i, j) : p->cmp(j, i);
+          if (rel != do_intersect) {
+            found = !do_intersect;
+            break;
+          }
+        }
+        if (found) bits[j / 64] |= uint64_t(1) << (j % 64);
+      }
+    }
+  }
+};
+
+// Return all predecessors (succ = false) or successors (succ = true) of the tuples inds (C indices),
+// the union or intersection (do_intersect = true) of the sets of all query tuples is returned
+// [[Rcpp::export]]
+NumericVector get_predsucc_impl(const DataFrame& scores, List serial_pref, const NumericVector& inds, bool do_intersect, bool succ, int N)
+{
+  NumericVector col1 = scores[0];
+  const int ntuples = col1.size();
+  if (ntuples == 0 || inds.size() == 0) return NumericVector();
+  
+  std::vector<int> query(inds.size());
+  for (int i = 0; i < inds.size(); i++) {
+    if (!(inds[i] >= 0 && inds[i] < ntuples)) stop("Index out of range!");
+    query[i] = inds[i];
+  }
+  
+  // De-Serialize preference
+  const ppref p = CreatePreference(serial_pref, scores);
+  
+  const int nwords = (ntuples + 63) / 64;
+  std::vector<uint64_t> bits(nwords);
+  
+  // Actual number of chunks (at least one word per chunk)
+  const int words_part = std::ceil(1.0 * nwords / N);
+  const int N_parts = std::ceil(1.0 * nwords / words_part);
+  
+  Predsucc_worker worker(p, query, do_intersect, succ, ntuples, words_part, bits);
+  if (N_parts == 1) worker(0, 1);
+  else              interrupt::parallel_for(0, N_parts, worker);
+  
+  // Indices of the set bits, ascending
+  std::vector<int> res;
+  for (int j = 0; j < ntuples; j++) {
+    if ((bits[j / 64] >> (j % 64)) & 1) res.push_back(j);
+  }
+  
+  return NumericVector(res.begin(), res.end());
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
+// Direct predecessors/successors on demand
+// ----------------------------------------
+
+hasse_neighbors::hasse_neighbors(const ppref& p, int ntuples) : m_p(p), m_ntuples(ntuples)
+{
+  for (int succ = 0; succ < 2; succ++) {
+    m_start[succ] = std::vector<int>(ntuples, -1);
+    m_count[succ] = std::vector<int>(ntuples);
+  }
+}
+
+std::vector<int> hasse_neighbors::get(int i, bool succ)
+{
+  if (m_start[succ][i] == -1) {
+    // All dominators/dominated tuples of i
+    std::vector<int> cand;
+    for (int j = 0; j < m_ntuples; j++) {
+      if (succ ? m_p->cmp(i, j) : m_p->cmp(j, i)) cand.push_back(j);
+    }
+    
+    // Direct successors are the maxima of the dominated tuples, direct predecessors are the minima of the dominators
+    // (a tuple between i and a candidate is also a candidate)
+    std::vector<int> res = succ ? bnl::run(cand, m_p) : bnl::run(cand, reversepref::make(m_p));
+    std::sort(res.begin(), res.end());
+    
+    m_start[succ][i] = m_adj[succ].size();
+    m_count[succ][i] = res.size();
+    m_adj[succ] += res;
+  }
+  
+  const auto begin = m_adj[succ].begin() + m_start[succ][i];
+  return std::vector<int>(begin, begin + m_count[succ][i]);
+}
+
+// Create the cache for the direct predecessors/successors
+// [[Rcpp::export]]
+SEXP get_hasse_cache_impl(const DataFrame& scores, List serial_pref)
+{
+  NumericVector col1 = scores[0];
+  const int ntuples = col1.size();
+  
+  // De-Serialize preference (the score vectors are copied)
+  const ppref p = CreatePreference(serial_pref, scores);
+  
+  return XPtr<hasse_neighbors>(new hasse_neighbors(p, ntuples), true);
+}
+
+// Union or intersection (do_intersect = true) of the direct predecessors (succ = false) or successors (succ = true)
+// of the tuples inds (C indices), ascending
+// [[Rcpp::export]]
+NumericVector get_hasse_predsucc_impl(SEXP cache, const NumericVector& inds, bool do_intersect, bool succ)
+{
+  XPtr<hasse_neighbors> neighbors(cache);
+  if (neighbors.get() == 0) stop("The cache for predecessors/successors is not available, call init_pred_succ again!");
+  
+  const int ntuples = neighbors->size();
+  const int ninds = inds.size();
+  for (int k = 0; k < ninds; k++) {
+    if (!(inds[k] >= 0 && inds[k] < ntuples)) stop("Index out of range!");
+  }
+  
+  // Count for each tuple how many of the (distinct) query tuples it is neighbor of
+  std::vector<int> query(inds.begin(), inds.end());
+  std::sort(query.begin(), query.end());
+  query.erase(std::unique(query.begin(), query.end()), query.end());
+  
+  std::vector<int> all;
+  for (int i : query) all += neighbors->get(i, succ);
+  std::sort(all.begin(), all.end());
+  
+  std::vector<int> res;
+  const int nall = all.size();
+  for (int k = 0; k < nall; ) {
+    int l = k;
+    while (l < nall && all[l] == all[k]) l++;
+    if (!do_intersect || l - k == static_cast<int>(query.size())) res.push_back(all[k]);
+    k = l;
+  }
+  
+  return NumericVector(res.begin(), res.end());
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
 // Return transitive reduction as 1-dim list (x1,x2,x3,x4) means
 // x1 < x2 and x3 < x4 in the sense of the transitive reduction
 std::list<int> get_transitive_reduction(const ppref& p, int ntuples)
@@ -3,3 +3,33 @@
 #include "pref-classes.h"
 
 std::list<int> get_transitive_reduction(const ppref& p, int ntuples);
+
+// Direct predecessors/successors of single tuples, calculated on demand
+// ---------------------------------------------------------------------
+
+// The direct predecessors of a tuple are the worst tuples among its dominators,
+// the direct successors are the best tuples among the tuples dominated by it.
+// Hence the Hasse diagram is never built, and computed neighborhoods are cached (compressed, like CSR).
+
+class hasse_neighbors
+{
+public:
+  
+  hasse_neighbors(const ppref& p, int ntuples);
+  
+  // Direct successors (succ = true) or predecessors of the tuple i, ascending
+  std::vector<int> get(int i, bool succ);
+  
+  int size() const { return m_ntuples; }
+  
+private:
+  
+  const ppref m_p;
+  const int m_ntuples;
+  
+  // Neighbors of tuple i are m_adj[succ][m_start[succ][i]], ..., m_adj[succ][m_start[succ][i] + m_count[succ][i] - 1],
+  // m_start[succ][i] is -1 if not yet computed
+  std::vector<int> m_start[2];
+  std::vector<int> m_count[2];
+  std::vector<int> m_adj[2];
+};
@@ -0,0 +1,67 @@
+#include "interrupt.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <exception>
+
+std::atomic<bool> interrupt::s_requested(false);
+thread_local const std::atomic<bool>* interrupt::t_token = nullptr;
+
+// Helper for R_ToplevelExec, R_CheckUserInterrupt does a longjmp if there is an interrupt
+static void check_interrupt_fn(void*)
+{
+  R_CheckUserInterrupt();
+}
+
+bool interrupt::pending()
+{
+  return R_ToplevelExec(check_interrupt_fn, NULL) == FALSE;
+}
+
+void interrupt::parallel_for(std::size_t begin, std::size_t end, RcppParallel::Worker& worker)
+{
+  // Interval for checking user interrupts in the main thread
+  const std::chrono::milliseconds check_interval(50);
+  
+  s_requested = false;
+  
+  std::mutex mtx;
+  std::condition_variable cv;
+  bool done = false;
+  
+  // Exceptions of the workers (e.g. std::bad_alloc) must not leave the thread, they are rethrown in the main thread
+  std::exception_ptr error;
+  
+  std::thread runner([&]() {
+    try {
+      RcppParallel::parallelFor(begin, end, worker);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    done = true;
+    cv.notify_one();
+  });
+  
+  // Wait for the workers, the algorithms stop early when s_requested is set
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      if (cv.wait_for(lock, check_interval, [&]() { return done; })) break;
+    }
+    if (!s_requested && pending()) s_requested = true;
+  }
+  runner.join();
+  
+  if (error) {
+    s_requested = false;
+    std::rethrow_exception(error);
+  }
+  
+  if (s_requested) {
+    s_requested = false;
+    throw Rcpp::internal::InterruptedException();
+  }
+}
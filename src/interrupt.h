@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Rcpp.h>
+#include <RcppParallel.h>
+#include <atomic>
+
+// User interrupts during long running (parallel) computations
+// -----------------------------------------------------------
+
+// The R API (R_CheckUserInterrupt) may only be called from the main thread.
+// Hence the main thread checks for interrupts while the computation runs in a background thread,
+// and the algorithms (BNL, SFS) poll the atomic flag and stop early.
+// Asynchronous jobs have their own cancellation token instead, which is polled in the same way by the thread running the job.
+
+class interrupt
+{
+public:
+  
+  // true if the current computation should be stopped, can be called from any thread
+  static bool requested()
+  {
+    // Jobs with a token are not affected by interrupts of the main thread
+    if (t_token != nullptr) return t_token->load(std::memory_order_relaxed);
+    return s_requested.load(std::memory_order_relaxed);
+  }
+  
+  // Set the cancellation token for the current thread (nullptr for none)
+  static void set_token(const std::atomic<bool>* token) { t_token = token; }
+  
+  // Check for a pending user interrupt, must be called from the main thread!
+  // Does not jump out of the C++ code (unlike Rcpp::checkUserInterrupt)
+  static bool pending();
+  
+  // Execute parallelFor in a background thread, while the main thread checks for user interrupts
+  // Throws Rcpp::internal::InterruptedException when the user interrupted the computation,
+  // exceptions of the workers are rethrown in the calling thread
+  static void parallel_for(std::size_t begin, std::size_t end, RcppParallel::Worker& worker);
+  
+private:
+  static std::atomic<bool> s_requested;
+  static thread_local const std::atomic<bool>* t_token;
+};
@@ -10,11 +10,126 @@ using namespace Rcpp;
 
 scorepref::scorepref(const NumericVector& data_) : data(as<std::vector<double>>(data_)) {}
 
+scorepref::scorepref(std::vector<double>&& data_) : data(std::move(data_)) {}
+
 ppref scorepref::make(const NumericVector& data_)
 {
   return std::make_shared<scorepref>(data_);
 }
 
+// Catpref and maker
+// -----------------
+
+catpref::catpref(std::vector<uint16_t>&& levels_, int domain_size_) : levels(std::move(levels_)), m_domain_size(domain_size_) {}
+
+ppref catpref::make(const NumericVector& codes, const NumericVector& lookup)
+{
+  const int ntuples = codes.size();
+  const int ncodes = lookup.size();
+  
+  std::vector<uint16_t> levels(ntuples);
+  std::vector<bool> used; // distinct levels
+  int domain_size = 0;
+  
+  for (int i = 0; i < ntuples; i++) {
+    const double code = codes[i];
+    if (!(code >= 0 && code < ncodes)) stop("Error during deserialization of preference: Invalid categorical code!");
+    const double level = lookup[static_cast<int>(code)];
+    if (!(level >= 0 && level <= UINT16_MAX)) { 
+      // Too many levels for small integers, use a usual score preference
+      std::vector<double> data(ntuples);
+      for (int j = 0; j < ntuples; j++) {
+        if (!(codes[j] >= 0 && codes[j] < ncodes)) stop("Error during deserialization of preference: Invalid categorical code!");
+        data[j] = lookup[static_cast<int>(codes[j])];
+      }
+      return std::make_shared<scorepref>(std::move(data));
+    }
+    levels[i] = static_cast<uint16_t>(level);
+    if (levels[i] >= used.size()) used.resize(levels[i] + 1);
+    if (!used[levels[i]]) {
+      used[levels[i]] = true;
+      domain_size++;
+    }
+  }
+  
+  return std::make_shared<catpref>(std::move(levels), domain_size);
+}
+
+// Distpref and maker
+// ------------------
+
+distpref::distpref(std::shared_ptr<const std::vector<double>> raw_, double left_, double right_) :
+  raw(std::move(raw_)), left(left_), right(right_) {}
+
+ppref distpref::make(const NumericVector& raw_, double left, double right)
+{
+  return std::make_shared<distpref>(std::make_shared<const std::vector<double>>(raw_.begin(), raw_.end()), left, right);
+}
+
+// Lexpref and maker
+// -----------------
+
+lexpref::lexpref(std::vector<double>&& ranks) : scorepref(std::move(ranks)) {}
+
+ppref lexpref::make(const std::vector<std::shared_ptr<leafpref>>& leaves, const std::vector<bool>& reversed)
+{
+  const int nleaves = leaves.size();
+  
+  const int ntuples = nleaves > 0 ? leaves[0]->size() : 0;
+  
+  // Values of the leaves
+  std::vector<std::vector<double>> cols(nleaves, std::vector<double>(ntuples));
+  for (int k = 0; k < nleaves; k++) {
+    for (int i = 0; i < ntuples; i++) cols[k][i] = leaves[k]->value(i);
+  }
+  
+  bool has_nan = false;
+  for (const std::vector<double>& col : cols) {
+    for (double val : col) {
+      if (std::isnan(val)) {
+        has_nan = true;
+        break;
+      }
+    }
+    if (has_nan) break;
+  }
+  
+  if (has_nan) { 
+    // Nested prior chain (prioritization is associative)
+    ppref res;
+    for (int k = 0; k < nleaves; k++) {
+      ppref leaf = leaves[k];
+      if (reversed[k]) leaf = reversepref::make(leaf);
+      res = (k == 0) ? leaf : prior::make(res, leaf);
+    }
+    return res;
+  }
+  
+  // Sort by the composite key
+  std::vector<int> order(ntuples);
+  for (int i = 0; i < ntuples; i++) order[i] = i;
+  
+  // -1 if tuple i is better than tuple j w.r.t. the lexicographic order, 1 if worse, 0 if equal
+  auto compare = [&](int i, int j) -> int {
+    for (int k = 0; k < nleaves; k++) {
+      const double vi = cols[k][i], vj = cols[k][j];
+      if (vi != vj) return ((vi < vj) != reversed[k]) ? -1 : 1;
+    }
+    return 0;
+  };
+  std::sort(order.begin(), order.end(), [&](int i, int j) { return compare(i, j) < 0; });
+  
+  // Dense rank (equal keys get equal ranks)
+  std::vector<double> ranks(ntuples);
+  int rank = 0;
+  for (int i = 0; i < ntuples; i++) {
+    if (i > 0 && compare(order[i - 1], order[i]) != 0) rank++;
+    ranks[order[i]] = rank;
+  }
+  
+  return std::make_shared<lexpref>(std::move(ranks));
+}
+
 // Reversepref and maker
 // ---------------------
 
@@ -74,6 +189,26 @@ bool scorepref::eq(int i, int j) const
   return data[i] == data[j];
 }
 
+bool distpref::cmp(int i, int j) const
+{
+  return value(i) < value(j);
+}
+
+bool distpref::eq(int i, int j) const
+{
+  return value(i) == value(j);
+}
+
+bool catpref::cmp(int i, int j) const
+{
+  return levels[i] < levels[j];
+}
+
+bool catpref::eq(int i, int j) const
+{
+  return levels[i] == levels[j];
+}
+
 bool reversepref::cmp(int i, int j) const
 {
   return p->cmp(j, i);
@@ -148,6 +283,38 @@ ppref_with_id DoCreatePreference(const List& pref_lst, const DataFrame& scores,
     next_id++;
     return ppref_with_id(res_pref, next_id);
     
+  } else if (pref_kind == 'c') {
+    
+    // Categorical preference, codes are in the score vector
+    ppref res_pref = catpref::make(as<NumericVector>(scores[next_id]), as<NumericVector>(pref_lst["lookup"]));
+    next_id++;
+    return ppref_with_id(res_pref, next_id);
+    
+  } else if (pref_kind == 'd') {
+    
+    // Distance to an interval (around/between), raw values are in the score vector
+    ppref res_pref = distpref::make(as<NumericVector>(scores[next_id]), as<double>(pref_lst["left"]), as<double>(pref_lst["right"]));
+    next_id++;
+    return ppref_with_id(res_pref, next_id);
+    
+  } else if (pref_kind == 'l') {
+    
+    // Prior chain of (reversed) leaf preferences
+    const List leaves_lst = as<List>(pref_lst["p"]);
+    const LogicalVector reversed = as<LogicalVector>(pref_lst["reversed"]);
+    const int nleaves = leaves_lst.size();
+    std::vector<std::shared_ptr<leafpref>> leaves(nleaves);
+    std::vector<bool> rev(nleaves);
+    for (int k = 0; k < nleaves; k++) {
+      pair_res1 = DoCreatePreference(as<List>(leaves_lst[k]), scores, next_id);
+      leaves[k] = std::dynamic_pointer_cast<leafpref>(pair_res1.first);
+      if (leaves[k] == 0) stop("Error during deserialization of preference: Unexpected preference in prior chain!");
+      next_id = pair_res1.second;
+      rev[k] = reversed[k];
+    }
+    ppref res_pref = lexpref::make(leaves, rev);
+    return ppref_with_id(res_pref, next_id);
+    
   } 
   
   stop("Error during deserialization of preference: Unexpected preference!");
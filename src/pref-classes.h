@@ -2,6 +2,9 @@
 
 #include <Rcpp.h>
 #include <memory>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
 
 // Preference classes using shared pointers
 // ----------------------------------------
@@ -91,21 +94,99 @@ public:
 };
 
 
-// Special score preference
-// ------------------------
+// Special score preferences
+// -------------------------
 
-class scorepref : public pref
+// Common superclass for preferences on a single value per tuple (smaller is better),
+// these are the dimensions for Scalagon and SFS
+class leafpref : public pref
+{
+public:
+  virtual double value(int i) const = 0;
+  
+  // Number of tuples
+  virtual int size() const = 0;
+  
+  // Number of distinct values if known in advance, 0 otherwise
+  virtual int domain_size() const { return 0; }
+};
+
+class scorepref : public leafpref
 {
 public:
   // this must not be a reference! (std::vector is faster than numeric vector)
   const std::vector<double> data;
   
   scorepref(const Rcpp::NumericVector& data);
+  scorepref(std::vector<double>&& data);
   
   static ppref make(const Rcpp::NumericVector& data_);
   
   bool cmp(int i, int j) const override;
   bool eq(int i, int j) const override;
+  
+  double value(int i) const override { return data[i]; }
+  int size() const override { return data.size(); }
+};
+
+// Categorical preference (layered), levels are stored as small integers
+class catpref : public leafpref
+{
+public:
+  const std::vector<uint16_t> levels;
+  
+  catpref(std::vector<uint16_t>&& levels, int domain_size);
+  
+  // Get the level of each tuple from the codes (0, 1, 2, ...) and the lookup table code -> level
+  static ppref make(const Rcpp::NumericVector& codes, const Rcpp::NumericVector& lookup);
+  
+  bool cmp(int i, int j) const override;
+  bool eq(int i, int j) const override;
+  
+  double value(int i) const override { return levels[i]; }
+  int size() const override { return levels.size(); }
+  int domain_size() const override { return m_domain_size; }
+  
+private:
+  const int m_domain_size;
+};
+
+// Distance to a preferred interval [left, right] (around/between), calculated from the raw values in the comparisons.
+// The raw values are shared, e.g., by the preferences of many query points of a dynamic Skyline
+class distpref : public leafpref
+{
+public:
+  const std::shared_ptr<const std::vector<double>> raw;
+  const double left;
+  const double right;
+  
+  distpref(std::shared_ptr<const std::vector<double>> raw, double left, double right);
+  
+  static ppref make(const Rcpp::NumericVector& raw_, double left, double right);
+  
+  bool cmp(int i, int j) const override;
+  bool eq(int i, int j) const override;
+  
+  // Same arithmetic as pmax(left - x, 0, x - right) in R, i.e., abs(x - center) for left = right = center
+  double value(int i) const override
+  {
+    const double x = (*raw)[i];
+    if (std::isnan(x)) return x;
+    return std::max(std::max(left - x, 0.0), x - right);
+  }
+  int size() const override { return raw->size(); }
+};
+
+// Prioritization chain of (reversed) leaf preferences, i.e., the lexicographic order of their values.
+// The composite key is stored as its dense rank, hence it is compared like a score preference
+// (a single comparison) and can be used as a dimension in Scalagon
+class lexpref : public scorepref
+{
+public:
+  lexpref(std::vector<double>&& ranks);
+  
+  // If there are NaN values the rank is not exact (NaN is incomparable), a nested prior chain is returned then
+  static ppref make(const std::vector<std::shared_ptr<leafpref>>& leaves, const std::vector<bool>& reversed);
 };
 
 
@@ -0,0 +1,212 @@
+#include "scalagon.h" // Includes BNL, pref classes and Scalagon
+#include "dedup.h"
+#include "bitmap.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+using namespace Rcpp;
+
+// Asynchronous preference selection
+// ---------------------------------
+
+// The preference (with copies of the score vectors), the seed for the samples of Scalagon and the duplicate classes
+// are prepared in the main thread. The selection runs in a background thread without any access to the R API,
+// the R session can poll, wait for or cancel the job via an external pointer.
+
+class psel_job
+{
+public:
+  
+  psel_job(const ppref& p, int ntuples, double alpha, const topk_setting& ts, bool is_top, bool show_levels,
+           bool use_bitmap, std::unique_ptr<dedup> dd, uint64_t seed) :
+    m_p(p), m_ntuples(ntuples), m_alpha(alpha), m_ts(ts), m_is_top(is_top), m_show_levels(show_levels),
+    m_use_bitmap(use_bitmap), m_dedup(std::move(dd)), m_seed(seed)
+  {
+    m_thread = std::thread([this]() { run(); });
+  }
+  
+  // Cancel and wait for the thread, called by the finalizer of the external pointer
+  ~psel_job()
+  {
+    cancel();
+    m_thread.join();
+  }
+  
+  bool done()
+  {
+    std::lock_guard<std::mutex> lock(m_mtx);
+    return m_done;
+  }
+  
+  // Wait at most timeout seconds, returns true if the job is done
+  bool wait_for(double timeout)
+  {
+    std::unique_lock<std::mutex> lock(m_mtx);
+    return m_cv.wait_for(lock, std::chrono::duration<double>(timeout), [this]() { return m_done; });
+  }
+  
+  void cancel() { m_cancelled = true; }
+  
+  bool cancelled() const { return m_cancelled; }
+  
+  // Error message of the job (empty if there was no error), only valid if the job is done
+  const std::string& error() const { return m_error; }
+  
+  // Result (pairs of level and tuple index), only valid if the job is done
+  const pair_vector& result() const { return m_res; }
+  
+private:
+  
+  const ppref m_p;
+  const int m_ntuples;
+  const double m_alpha;
+  const topk_setting m_ts;
+  const bool m_is_top;
+  const bool m_show_levels;
+  const bool m_use_bitmap;
+  const std::unique_ptr<dedup> m_dedup; // nullptr if not used
+  const uint64_t m_seed; // for the samples of Scalagon
+  
+  std::atomic<bool> m_cancelled{false};
+  
+  std::mutex m_mtx;
+  std::condition_variable m_cv;
+  bool m_done = false;
+  
+  std::string m_error;
+  pair_vector m_res;
+  
+  std::thread m_thread;
+  
+  // Job, runs in the background thread
+  void run()
+  {
+    interrupt::set_token(&m_cancelled);
+    try {
+      std::vector<int> v;
+      if (m_dedup) {
+        v = m_dedup->representatives();
+      } else {
+        v = std::vector<int>(m_ntuples);
+        for (int i = 0; i < m_ntuples; i++) v[i] = i;
+      }
+      
+      scalagon scal_alg{sampler(m_seed)};
+      bitmap_skyline bm;
+      const bool has_bitmap = m_use_bitmap && bm.init(v, m_p);
+      
+      if (!m_is_top) {
+        std::vector<int> res = has_bitmap ? bm.run() : scal_alg.run(v, m_p, m_alpha);
+        if (m_dedup) res = m_dedup->expand(res);
+        m_res = bnl::add_level(res, 1);
+      } else {
+        // The levels of the representatives are needed to expand them
+        const bool calc_levels = m_show_levels || m_dedup;
+        flex_vector res = has_bitmap ? bm.run_topk(m_ts, calc_levels) : scal_alg.run_topk(v, m_p, m_ts, m_alpha, calc_levels);
+        if (m_dedup) res = m_dedup->expand_levels(res.second, m_ts, m_show_levels);
+        // Without levels: level 0 (not available)
+        if (m_show_levels) m_res = res.second;
+        else               m_res = bnl::add_level(res.first, 0);
+      }
+    } catch (std::exception& e) {
+      m_error = e.what();
+    }
+    interrupt::set_token(nullptr);
+    
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_done = true;
+    m_cv.notify_all();
+  }
+};
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
+// Start the job (non-grouped preference selection, with or without top-k)
+// [[Rcpp::export]]
+SEXP psel_async_impl(const DataFrame& scores, const List& serial_pref, double alpha, bool is_top,
+                     int top, int at_least, int toplevel, bool and_connected, bool show_levels,
+                     bool use_dedup, bool use_bitmap)
+{
+  NumericVector col1 = scores[0];
+  const int ntuples = col1.size();
+  
+  const topk_setting ts(top, at_least, toplevel, and_connected);
+  const ppref p = CreatePreference(serial_pref, scores);
+  
+  // Duplicate classes and seed (R API) in the main thread
+  std::unique_ptr<dedup> dd(new dedup());
+  if (!(use_dedup && ntuples > 0 && dd->init(scores))) dd.reset();
+  
+  return XPtr<psel_job>(new psel_job(p, ntuples, alpha, ts, is_top, show_levels, use_bitmap, std::move(dd),
+                                     sampler::seed_from_r()), true);
+}
+
+// true if the job is done
+// [[Rcpp::export]]
+bool psel_async_poll_impl(SEXP job)
+{
+  XPtr<psel_job> ptr(job);
+  if (ptr.get() == 0) stop("The asynchronous preference selection is not available!");
+  return ptr->done();
+}
+
+// Wait for the job at most timeout seconds (forever if timeout <= 0), returns true if the job is done.
+// User interrupts stop waiting, but do not cancel the job
+// [[Rcpp::export]]
+bool psel_async_wait_impl(SEXP job, double timeout)
+{
+  XPtr<psel_job> ptr(job);
+  if (ptr.get() == 0) stop("The asynchronous preference selection is not available!");
+  
+  // Interval for checking user interrupts in the main thread
+  const double check_interval = 0.05;
+  const auto start = std::chrono::steady_clock::now();
+  while (true) {
+    double wait = check_interval;
+    if (timeout > 0) {
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      wait = std::min(wait, timeout - elapsed.count());
+      if (wait <= 0) return ptr->done();
+    }
+    if (ptr->wait_for(wait)) return true;
+    checkUserInterrupt();
+  }
+}
+
+// [[Rcpp::export]]
+void psel_async_cancel_impl(SEXP job)
+{
+  XPtr<psel_job> ptr(job);
+  if (ptr.get() == 0) stop("The asynchronous preference selection is not available!");
+  ptr->cancel();
+}
+
+// Result of a finished job
+// [[Rcpp::export]]
+DataFrame psel_async_result_impl(SEXP job)
+{
+  XPtr<psel_job> ptr(job);
+  if (ptr.get() == 0) stop("The asynchronous preference selection is not available!");
+  if (!ptr->done()) stop("The asynchronous preference selection is not finished yet!");
+  if (ptr->cancelled()) stop("The asynchronous preference selection was cancelled!");
+  if (!ptr->error().empty()) stop(ptr->error());
+  
+  const pair_vector& res = ptr->result();
+  const int nres = res.size();
+  std::vector<int> res_ind;
+  std::vector<int> res_levels;
+  res_ind.reserve(nres);
+  res_levels.reserve(nres);
+  
+  for (const std::pair<int, int>& u : res) {
+    res_levels.push_back(u.first);
+    res_ind.push_back(u.second);
+  }
+  
+  return DataFrame::create(
+    Named(".index") = NumericVector(res_ind.begin(), res_ind.end()),
+    Named(".level") = NumericVector(res_levels.begin(), res_levels.end()));
+}
@@ -0,0 +1,185 @@
+// [[Rcpp::depends(RcppParallel)]]
+#include <RcppParallel.h>
+using namespace RcppParallel;
+
+#include "scalagon.h" // Includes BNL, pref classes and Scalagon
+
+using namespace Rcpp;
+
+// Estimation of the level sizes
+// -----------------------------
+
+// The exact level of each sample tuple (up to maxlevel) is calculated from its dominators only:
+// all dominators of a dominator u of t are also dominators of t, hence the level of u within the dominators of t
+// is the level of u in the whole data set, and level(t) = 1 + (number of levels of the dominators of t).
+// Sample tuples with a lower bound > maxlevel from the Scalagon lattice are skipped.
+// The dominators of a tuple in the lattice are searched in the cells with smaller or equal coordinates and the outliers only.
+// To bound the effort per sample tuple, the levels are calculated for a random subset of at most max_dom dominators
+// (reservoir sample). The levels within a subset are not larger than the actual levels, hence a capped sample tuple
+// gets a lower bound of its level. If the subset already has more than maxlevel - 1 levels, the tuple is
+// certainly not within the first maxlevel levels.
+
+// Tuples grouped by their cells in the Scalagon lattice
+class dominator_index
+{
+public:
+  
+  // cells: cell of each tuple (-1 for outliers), empty if Scalagon is not applicable
+  dominator_index(const scalagon& scal, const std::vector<int>& cells, int ntuples) : m_scal(scal), m_ntuples(ntuples)
+  {
+    if (cells.empty()) return;
+    m_cells = cells;
+    
+    // Outliers first, then the tuples sorted by their cells
+    m_tuples.resize(ntuples);
+    for (int i = 0; i < ntuples; i++) m_tuples[i] = i;
+    std::stable_sort(m_tuples.begin(), m_tuples.end(), [&](int i, int j) { return m_cells[i] < m_cells[j]; });
+    for (int pos = 0; pos < ntuples; pos++) {
+      const int c = m_cells[m_tuples[pos]];
+      if (c == -1) {
+        m_noutliers++;
+      } else if (m_cell_ids.empty() || m_cell_ids.back() != c) {
+        m_cell_ids.push_back(c);
+        m_starts.push_back(pos);
+      }
+    }
+    m_starts.push_back(ntuples);
+  }
+  
+  // Call f(j) for all tuples j which may dominate i, until f returns true
+  template<typename F>
+  void for_candidates(int i, F f) const
+  {
+    if (m_cells.empty() || m_cells[i] == -1) {
+      for (int j = 0; j < m_ntuples; j++) if (f(j)) return;
+      return;
+    }
+    
+    for (int pos = 0; pos < m_noutliers; pos++) if (f(m_tuples[pos])) return;
+    // The cell index is increasing in all coordinates, cells with a larger index cannot contain dominators
+    const int nc = m_cell_ids.size();
+    for (int c = 0; c < nc && m_cell_ids[c] <= m_cells[i]; c++) {
+      if (!m_scal.cell_leq(m_cell_ids[c], m_cells[i])) continue;
+      for (int pos = m_starts[c]; pos < m_starts[c + 1]; pos++) if (f(m_tuples[pos])) return;
+    }
+  }
+  
+private:
+  const scalagon& m_scal;
+  const int m_ntuples;
+  std::vector<int> m_cells;
+  std::vector<int> m_tuples;
+  std::vector<int> m_cell_ids; // non-empty cells (sorted)
+  std::vector<int> m_starts;   // start of each cell in m_tuples (and the end)
+  int m_noutliers = 0;
+};
+
+class Estimate_worker : public Worker {
+public:
+  const ppref& p;
+  const std::vector<int>& sample;
+  const std::vector<int>& bounds; // may be empty
+  const dominator_index& index;
+  const int maxlevel;
+  const int sample_part;
+  const int max_dom;
+  const uint64_t seed; // each chunk uses its own stream (1, 2, ...)
+  std::vector<int>& levels; // level of each sample tuple, 0 if it is larger than maxlevel
+  std::vector<int>& capped; // 1 if the level was calculated from a subset of the dominators
+
+  Estimate_worker(const ppref& p, const std::vector<int>& sample, const std::vector<int>& bounds,
+                  const dominator_index& index, int maxlevel, int sample_part, int max_dom, uint64_t seed,
+                  std::vector<int>& levels, std::vector<int>& capped) :
+    p(p), sample(sample), bounds(bounds), index(index), maxlevel(maxlevel), sample_part(sample_part),
+    max_dom(max_dom), seed(seed), levels(levels), capped(capped) {}
+
+  void operator()(std::size_t begin, std::size_t end)
+  {
+    const int nsample = sample.size();
+    for (std::size_t k = begin; k < end; k++) {
+      const int from = k * sample_part;
+      const int to = std::min(nsample, static_cast<int>(k + 1) * sample_part);
+      sampler rng(seed, k + 1);
+      for (int s = from; s < to; s++) {
+        if (interrupt::requested()) return; // result is discarded
+        const int i = sample[s];
+        if (!bounds.empty() && bounds[i] > maxlevel) continue;
+
+        // All dominators of i or a reservoir sample of them (for maxlevel = 1 the first one is sufficient)
+        std::vector<int> dom;
+        int ndom = 0;
+        index.for_candidates(i, [&](int j) {
+          if (!p->cmp(j, i)) return false;
+          ndom++;
+          if (static_cast<int>(dom.size()) < max_dom) {
+            dom.push_back(j);
+          } else {
+            const int r = rng.next_int(ndom);
+            if (r < max_dom) dom[r] = j;
+          }
+          return maxlevel == 1;
+        });
+        if (ndom > max_dom) capped[s] = 1;
+
+        if (dom.empty()) {
+          levels[s] = 1;
+        } else if (maxlevel > 1) {
+          // Levels of the dominators up to maxlevel - 1, all dominators must be within these levels
+          const pair_vector lev = bnl::run_topk_lev(dom, p, topk_setting(-1, -1, maxlevel - 1, true));
+          if (lev.size() == dom.size()) levels[s] = 1 + lev.back().first;
+        }
+      }
+    }
+  }
+};
+
+// Sampled tuples and their levels (0 if larger than maxlevel), all tuples are evaluated if sample_size >= ntuples.
+// The confidence bounds are calculated in R.
+// [[Rcpp::export]]
+DataFrame psel_estimate_impl(const DataFrame& scores, List serial_pref, int sample_size, int maxlevel,
+                             int max_dom, double alpha, int N)
+{
+  NumericVector col1 = scores[0];
+  const int ntuples = col1.size();
+  if (ntuples == 0) {
+    return DataFrame::create(Named(".index") = NumericVector(), Named(".level") = NumericVector(),
+                             Named(".capped") = LogicalVector());
+  }
+
+  // De-Serialize preference
+  const ppref p = CreatePreference(serial_pref, scores);
+
+  std::vector<int> v(ntuples);
+  for (int i = 0; i < ntuples; i++) v[i] = i;
+
+  // Seed for the sample (stream 0) and the subsets of the dominators (streams 1, ...)
+  const uint64_t seed = sampler::seed_from_r();
+
+  // Sample (with replacement) or all tuples
+  std::vector<int> sample;
+  if (sample_size < ntuples) {
+    sampler rng(seed);
+    sample = rng.sample(ntuples, sample_size);
+  } else {
+    sample = v;
+  }
+  const int nsample = sample.size();
+
+  // Lower bounds of the levels from the scaled lattice (if Scalagon is applicable)
+  scalagon scal_alg;
+  const std::vector<int> bounds = scal_alg.level_bounds(v, p, alpha);
+  const dominator_index index(scal_alg, bounds.empty() ? std::vector<int>() : scal_alg.cells(), ntuples);
+
+  // Actual number of chunks of the sample
+  const int sample_part = std::ceil(1.0 * nsample / N);
+  const int N_parts = std::ceil(1.0 * nsample / sample_part);
+
+  std::vector<int> levels(nsample);
+  std::vector<int> capped(nsample);
+  Estimate_worker worker(p, sample, bounds, index, maxlevel, sample_part, max_dom, seed, levels, capped);
+  interrupt::parallel_for(0, N_parts, worker);
+
+  return DataFrame::create(Named(".index") = NumericVector(sample.begin(), sample.end()),
+                           Named(".level") = NumericVector(levels.begin(), levels.end()),
+                           Named(".capped") = LogicalVector(capped.begin(), capped.end()));
+}
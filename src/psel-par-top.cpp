@@ -3,6 +3,8 @@
 using namespace RcppParallel;
 
 #include "scalagon.h" // Includes BNL, pref classes and Scalagon
+#include "dedup.h"
+#include "bitmap.h"
 
 using namespace Rcpp;
 
@@ -15,22 +17,19 @@ public:
   const ppref p;
   const double alpha;
   const topk_setting &ts;
-  const std::vector<std::vector<int>> &samples_ind;
+  const uint64_t seed; // each partition/group uses its own stream
   std::vector<std::vector<int>> results;
 
   // initialize from Rcpp input and output matrices (the RMatrix class
   // can be automatically converted to from the Rcpp matrix type)
   Psel_worker_top(const std::vector<std::vector<int>> &vs, const ppref &p,
-                  int N, double alpha, const topk_setting &ts,
-                  const std::vector<std::vector<int>> &samples_ind)
-      : vs(vs), p(p), alpha(alpha), ts(ts), samples_ind(samples_ind),
-        results(N) {}
+                  int N, double alpha, const topk_setting &ts, uint64_t seed)
+      : vs(vs), p(p), alpha(alpha), ts(ts), seed(seed), results(N) {}
 
   // function call operator that work for the specified range (begin/end)
   void operator()(std::size_t begin, std::size_t end) {
     for (std::size_t k = begin; k < end; k++) {
-      scalagon scal_alg(true);
-      scal_alg.sample_ind = samples_ind[k];
+      scalagon scal_alg(sampler(seed, k));
       // Levels make no sense in parallel runs! Take only the indices here
       // (first member of flex_list)
       results[k] = scal_alg.run_topk(vs[k], p, ts, alpha, false).first;
@@ -48,22 +47,20 @@ public:
   const ppref p;
   const double alpha;
   const topk_setting &ts;
-  const std::vector<std::vector<int>> &samples_ind;
+  const uint64_t seed; // each group uses its own stream
   std::vector<pair_vector> results;
 
   // initialize from Rcpp input and output matrices (the RMatrix class
   // can be automatically converted to from the Rcpp matrix type)
   Psel_worker_top_level(std::vector<std::vector<int>> &vs, const ppref &p,
                         int N, double alpha, const topk_setting &ts,
-                        std::vector<std::vector<int>> &samples_ind)
-      : vs(vs), p(p), alpha(alpha), ts(ts), samples_ind(samples_ind),
-        results(N) {}
+                        uint64_t seed)
+      : vs(vs), p(p), alpha(alpha), ts(ts), seed(seed), results(N) {}
 
   // function call operator that work for the specified range (begin/end)
   void operator()(std::size_t begin, std::size_t end) {
     for (std::size_t k = begin; k < end; k++) {
-      scalagon scal_alg(true);
-      scal_alg.sample_ind = samples_ind[k];
+      scalagon scal_alg(sampler(seed, k));
       // Levels are true in this class!
       results[k] = scal_alg.run_topk(vs[k], p, ts, alpha, true)
                        .second; // second is pair_list
@@ -73,6 +70,81 @@ public:
 
 // --------------------------------------------------------------------------------------------------------------------------------
 
+// Parallel level-by-level peeling for top-k selections which are not cut to a few tuples
+//
+// Each partition keeps its remaining tuples. For each level, the partitions calculate their local maxima (phase 1),
+// then each local maximum is compared with the local maxima of all other partitions (phase 2). The undominated ones
+// form the global level, the dominated ones stay in their partition for the next level.
+// Only the local maxima are shared between the threads, i.e., the threads synchronize once per phase of each level.
+
+class Peel_worker : public Worker {
+public:
+  const ppref p;
+  std::vector<std::vector<int>> remaining; // remaining tuples of each partition
+  std::vector<std::vector<int>> local_max; // local maxima of the current level
+  std::vector<std::vector<int>> level_res; // part of the global level from each partition
+  bool global_phase = false;
+
+  Peel_worker(std::vector<std::vector<int>> &&vs, const ppref &p)
+      : p(p), remaining(std::move(vs)), local_max(remaining.size()),
+        level_res(remaining.size()) {}
+
+  void operator()(std::size_t begin, std::size_t end) {
+    const std::size_t nparts = remaining.size();
+    for (std::size_t k = begin; k < end; k++) {
+      if (!global_phase) {
+        std::vector<int> remainder;
+        local_max[k] = bnl::run_remainder(remaining[k], remainder, p);
+        std::swap(remaining[k], remainder);
+      } else {
+        level_res[k].clear();
+        for (int u : local_max[k]) {
+          if (interrupt::requested()) return; // result is discarded
+          bool dominated = false;
+          for (std::size_t j = 0; j < nparts && !dominated; j++) {
+            if (j == k) continue; // local maxima do not dominate each other
+            for (int v : local_max[j]) {
+              if (p->cmp(v, u)) {
+                dominated = true;
+                break;
+              }
+            }
+          }
+          if (dominated) remaining[k].push_back(u);
+          else level_res[k].push_back(u);
+        }
+      }
+    }
+  }
+};
+
+// Levels (<level, index>) of the partitioned tuples until the top-k setting breaks
+static pair_vector run_topk_peeling(std::vector<std::vector<int>> &&vs, const ppref &p,
+                                    const topk_setting &ts) {
+  const int nparts = vs.size();
+  Peel_worker worker(std::move(vs), p);
+  pair_vector res;
+
+  int level = 1;
+  while (true) {
+    worker.global_phase = false;
+    interrupt::parallel_for(0, nparts, worker);
+    worker.global_phase = true;
+    interrupt::parallel_for(0, nparts, worker);
+
+    const std::size_t nres = res.size();
+    for (int k = 0; k < nparts; k++) res += bnl::add_level(worker.level_res[k], level);
+    if (res.size() == nres) break; // no more tuples
+    if (ts.do_break(level, res.size())) break;
+    level++;
+  }
+
+  ts.cut(res);
+  return res;
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
 // Parallel NON-grouped preference TOP K selection
 // ===============================================
 
@@ -82,7 +154,8 @@ public:
 DataFrame pref_select_top_impl(const DataFrame &scores, const List &serial_pref,
                                int N, double alpha, int top, int at_least,
                                int toplevel, bool and_connected,
-                               bool show_levels) {
+                               bool show_levels, bool use_dedup,
+                               bool use_bitmap) {
   NumericVector col1 = scores[0];
   const int ntuples = col1.size();
 
@@ -97,56 +170,92 @@ DataFrame pref_select_top_impl(const DataFrame &scores, const List &serial_pref,
   // Scalagon instance
   scalagon scal_alg;
 
-  // Execute algorithm for non-parallel case
-  if (N == 1) {
-
-    // Create index vector
-    std::vector<int> v(ntuples);
+  // Tuples to be evaluated: all tuples or one representative per class of duplicates
+  dedup dd;
+  const bool has_dups = use_dedup && dd.init(scores);
+  std::vector<int> v;
+  if (has_dups) {
+    v = dd.representatives();
+  } else {
+    v = std::vector<int>(ntuples);
     for (int i = 0; i < ntuples; i++)
       v[i] = i;
+  }
+  const int nv = v.size();
+
+  // The levels of the representatives are needed to expand them
+  const bool calc_levels = show_levels || has_dups;
+
+  // Bitmap skyline for small domains
+  bitmap_skyline bm;
+
+  if (use_bitmap && bm.init(v, p)) {
+
+    // Bitmap skyline for small domains, levels are peeled off using N threads
+    res = bm.run_topk(ts, calc_levels, N);
+
+  } else if (N == 1) { // Execute algorithm for non-parallel case
 
-    res = scal_alg.run_topk(v, p, ts, alpha, show_levels); // res is flex_vector
+    res = scal_alg.run_topk(v, p, ts, alpha, calc_levels); // res is flex_vector
 
   } else { // N > 1, parallel case
 
     // Tuples per partition
-    int tuples_part = std::ceil(1.0 * ntuples / N);
+    int tuples_part = std::ceil(1.0 * nv / N);
 
     // Actual number of partitions (N_parts < N for very small numbers of
     // ntuples like ntuples = 5)
-    int N_parts = std::ceil(1.0 * ntuples / tuples_part);
+    int N_parts = std::ceil(1.0 * nv / tuples_part);
 
     // Create N_parts index vectors (for parallelization)
     std::vector<std::vector<int>> vs(N_parts);
-    std::vector<std::vector<int>> samples_ind(N_parts);
 
     int count = 0;
     for (int k = 0; k < N_parts; k++) {
-      const int local_n = (k == N_parts - 1) ? ntuples - count : tuples_part;
+      const int local_n = (k == N_parts - 1) ? nv - count : tuples_part;
 
-      samples_ind[k] = get_sample(local_n); // Sample indices for this partition
       vs[k] = std::vector<int>(local_n);
       for (int i = 0; i < local_n; i++) {
-        vs[k][i] = count;
+        vs[k][i] = v[count];
         count++;
       }
     }
 
-    // Create worker and execute parallel
-    Psel_worker_top worker(vs, p, N_parts, alpha, ts, samples_ind);
-    parallelFor(0, N_parts, worker);
+    // Selections cut to k < ntuples tuples: local top-k (with early stop) and merge
+    const bool is_cut = ts.topk != -1 && ts.topk < nv &&
+                        (ts.and_connected || (ts.toplevel == -1 && ts.at_least == -1));
 
-    std::vector<int> vector_merged;
+    if (is_cut) {
 
-    // Clue together
-    for (int k = 0; k < N_parts; k++)
-      vector_merged += worker.results[k];
+      // Create worker and execute parallel
+      Psel_worker_top worker(vs, p, N_parts, alpha, ts, sampler::seed_from_r());
+      interrupt::parallel_for(0, N_parts, worker);
 
-    // Merge and execute top k Scalagon/BNL again, potentially WITH LEVELS
-    res = scal_alg.run_topk(vector_merged, p, ts, alpha,
-                            show_levels); // res is flex_vector
+      std::vector<int> vector_merged;
+
+      // Clue together
+      for (int k = 0; k < N_parts; k++)
+        vector_merged += worker.results[k];
+
+      // Merge and execute top k Scalagon/BNL again, potentially WITH LEVELS
+      res = scal_alg.run_topk(vector_merged, p, ts, alpha,
+                              calc_levels); // res is flex_vector
+
+    } else {
+
+      // Many levels: peel them off in parallel
+      res.second = run_topk_peeling(std::move(vs), p, ts);
+      if (!calc_levels) {
+        for (const std::pair<int, int> &u : res.second)
+          res.first.push_back(u.second);
+      }
+    }
   }
 
+  // Levels of all tuples of the classes (the top-k setting is applied to the number of tuples)
+  if (has_dups)
+    res = dd.expand_levels(res.second, ts, show_levels);
+
   if (!show_levels) {
     // Return just indices (first member of flex_vector)
     return DataFrame::create(
@@ -199,15 +308,13 @@ DataFrame grouped_pref_sel_top_impl(const List &indices,
 
   // Compose indices for parallel case (for show_levels \in {FALSE, TRUE})
   std::vector<std::vector<int>> vs;
-  std::vector<std::vector<int>> samples_ind;
+  uint64_t seed = 0; // Seed for the samples in the workers
   if (N > 1) { // vs is only used for the parallel case!
     vs = std::vector<std::vector<int>>(nind);
-    samples_ind = std::vector<std::vector<int>>(nind);
     for (int i = 0; i < nind; i++) {
       vs[i] = as<std::vector<int>>(indices[i]);
-      samples_ind[i] =
-          get_sample(vs[i].size()); // Sample indices for this partition
     }
+    seed = sampler::seed_from_r();
   }
 
   if (!show_levels) {
@@ -219,10 +326,10 @@ DataFrame grouped_pref_sel_top_impl(const List &indices,
     if (N > 1) { // parallel case - process groups in parallel
 
       // Create worker
-      Psel_worker_top worker(vs, p, nind, alpha, ts, samples_ind);
+      Psel_worker_top worker(vs, p, nind, alpha, ts, seed);
 
       // Execute parallel
-      parallelFor(0, nind, worker);
+      interrupt::parallel_for(0, nind, worker);
 
       // Clue together
       for (int i = 0; i < nind; i++)
@@ -249,10 +356,10 @@ DataFrame grouped_pref_sel_top_impl(const List &indices,
     if (N > 1) { // parallel case - process groups in parallel
 
       // Create worker for top-k WITH levels
-      Psel_worker_top_level worker(vs, p, nind, alpha, ts, samples_ind);
+      Psel_worker_top_level worker(vs, p, nind, alpha, ts, seed);
 
       // Execute parallel
-      parallelFor(0, nind, worker);
+      interrupt::parallel_for(0, nind, worker);
 
       // Clue together
       for (int i = 0; i < nind; i++)
@@ -3,12 +3,18 @@
 using namespace RcppParallel;
 
 #include "scalagon.h" // Includes BNL, pref classes and Scalagon
+#include "filter-points.h"
+#include "dedup.h"
+#include "bitmap.h"
+#include "epsilon.h"
+
+#include <limits>
 
 using namespace Rcpp;
 
 // Scalagon/BNL Wrapper for parallel and non-parallel. 
 
-// for non-grouping / grouping and non-topk
+// for non-grouping and non-topk
 // Adding functionality for top-k does not make sense - top-k returns a pairlist!
 class Psel_worker : public Worker {
 public:
@@ -18,20 +24,32 @@ public:
   double alpha;
   
   std::vector<std::vector<int>> results;
-  std::vector<std::vector<int>> samples_ind;
+  
+  // Seed for the samples of Scalagon (drawn in the main thread), each partition uses its own stream
+  uint64_t seed;
+  
+  // Global filter points (may be empty)
+  const std::vector<int>& fpoints;
   
   // initialize from Rcpp input and output matrixes (the RMatrix class
   // can be automatically converted to from the Rcpp matrix type)
-  Psel_worker(std::vector<std::vector<int>>& vs, ppref p, int N, double alpha, std::vector<std::vector<int>>& samples_ind) : 
-    vs(vs), p(p), alpha(alpha), results(N), samples_ind(samples_ind) {}
+  Psel_worker(std::vector<std::vector<int>>& vs, ppref p, int N, double alpha, uint64_t seed,
+              const std::vector<int>& fpoints) : 
+    vs(vs), p(p), alpha(alpha), results(N), seed(seed), fpoints(fpoints) {}
    
    // function call operator that work for the specified range (begin/end)
   void operator()(std::size_t begin, std::size_t end)
   {
     for (std::size_t k = begin; k < end; k++) {
-      scalagon scal_alg(true);
-      scal_alg.sample_ind = samples_ind[k];
-      results[k] = scal_alg.run(vs[k], p, alpha);
+      scalagon scal_alg(sampler(seed, k));
+      if (fpoints.empty()) {
+        results[k] = scal_alg.run(vs[k], p, alpha);
+      } else {
+        // Discard tuples dominated by filter points before BNL/Scalagon
+        const std::vector<int> v = filter_points::filter(vs[k], fpoints, p);
+        if (v.empty()) continue;
+        results[k] = scal_alg.run(v, p, alpha);
+      }
     }
   }
 };
@@ -43,7 +61,7 @@ public:
 // subdivide dataset in N parts
 
 // [[Rcpp::export]]
-NumericVector pref_select_impl(const DataFrame& scores, const List& serial_pref, int N, double alpha)
+NumericVector pref_select_impl(const DataFrame& scores, const List& serial_pref, int N, double alpha, bool use_dedup, bool use_bitmap)
 {
   NumericVector col1 = scores[0];
   const int ntuples = col1.size();
@@ -57,44 +75,65 @@ NumericVector pref_select_impl(const DataFrame& scores, const List& serial_pref,
   // Scalagon instance for non-parallel run or final run in parallel case
   scalagon scal_alg;
   
-  // Execute algorithm for non-parallel case
-  if (N == 1) {
-    
-    // Create index vector
-    std::vector<int> v(ntuples);
+  // Tuples to be evaluated: all tuples or one representative per class of duplicates
+  dedup dd;
+  const bool has_dups = use_dedup && dd.init(scores);
+  std::vector<int> v;
+  if (has_dups) {
+    v = dd.representatives();
+  } else {
+    v = std::vector<int>(ntuples);
     for (int i = 0; i < ntuples; i++) v[i] = i;
+  }
+  const int nv = v.size();
+  
+  // Bitmap skyline for small domains (parallel over the tuples)
+  bitmap_skyline bm;
+  
+  if (use_bitmap && bm.init(v, p)) {
+    
+    res = bm.run(N);
+    
+  } else if (N == 1) { // Execute algorithm for non-parallel case
     
     res = scal_alg.run(v, p, alpha);
   
   } else { // N > 1, parallel case
   
     // Tuples per partition
-    int tuples_part = std::ceil(1.0 * ntuples / N);
+    int tuples_part = std::ceil(1.0 * nv / N);
     
     // Actual number of partitions (N_parts < N for very small numbers of ntuples like ntuples = 5)
-    int N_parts = std::ceil(1.0 * ntuples / tuples_part);
+    int N_parts = std::ceil(1.0 * nv / tuples_part);
   
     // Create N_parts index vectors (for parallelization)
     std::vector<std::vector<int>> vs(N_parts);
-    std::vector<std::vector<int>> samples_ind(N_parts);
   
     int count = 0;
     for (int k = 0; k < N_parts; k++) {
       int local_n;
-      if (k == N_parts - 1) local_n = ntuples - count;
+      if (k == N_parts - 1) local_n = nv - count;
       else                  local_n = tuples_part;
       
-      samples_ind[k] = get_sample(local_n);
       vs[k] = std::vector<int>(local_n);
       for (int i = 0; i < local_n; i++) {
-        vs[k][i] = count;
+        vs[k][i] = v[count];
         count++;
       }
     }
     
+    // Seed for all samples
+    const uint64_t seed = sampler::seed_from_r();
+    
+    // Filter points from a global sample (stream N_parts), given to all workers
+    sampler rng(seed, N_parts);
+    std::vector<int> sample = get_sample(nv, rng);
+    for (int& i : sample) i = v[i];
+    const std::vector<int> fpoints = filter_points::get(sample, p);
+    
     // Create worker and execute parallel
-    Psel_worker worker(vs, p, N_parts, alpha, samples_ind);
-    parallelFor(0, N_parts, worker);
+    Psel_worker worker(vs, p, N_parts, alpha, seed, fpoints);
+    interrupt::parallel_for(0, N_parts, worker);
     
     // Clue together
     for (int k = 0; k < N_parts; k++) res += worker.results[k];
@@ -103,11 +142,82 @@ NumericVector pref_select_impl(const DataFrame& scores, const List& serial_pref,
     res = scal_alg.run(res, p, alpha);
   }
   
+  // All tuples equivalent to the maxima are maxima
+  if (has_dups) res = dd.expand(res);
+  
   // Return result
   return NumericVector(res.begin(), res.end());
 }
 
 
+// --------------------------------------------------------------------------------------------------------------------------------
+
+// Batches of groups for grouped preference selection
+
+// All indices of a batch are stored contiguously, either a single large group (evaluated by Scalagon)
+// or many small groups (evaluated by segmented BNL without any setup per group)
+struct group_batch
+{
+  std::vector<int> indices;
+  std::vector<int> offsets = std::vector<int>(1); // group g is [offsets[g], offsets[g+1])
+  bool large = false;
+};
+
+// Subdivide the groups into batches with at most max_tuples tuples (single large groups may be larger)
+std::vector<group_batch> get_group_batches(const List& indices, int max_tuples)
+{
+  std::vector<group_batch> batches(1);
+  
+  const int nind = indices.length();
+  for (int i = 0; i < nind; i++) {
+    NumericVector group = indices[i];
+    const int n = group.size();
+    const bool large = n >= scalagon::scalagon_min_tuples;
+    
+    // Start a new batch if the current one is not empty and the group does not fit
+    if (batches.back().offsets.size() > 1 && 
+        (large || batches.back().large || static_cast<int>(batches.back().indices.size()) + n > max_tuples)) {
+      batches.push_back(group_batch());
+    }
+    
+    group_batch& batch = batches.back();
+    batch.large = large;
+    for (int j = 0; j < n; j++) batch.indices.push_back(group[j]);
+    batch.offsets.push_back(batch.indices.size());
+  }
+  
+  return batches;
+}
+
+// Evaluate a batch of groups, the result is appended to res
+void run_group_batch(const group_batch& batch, const ppref& p, double alpha, scalagon& scal_alg, std::vector<int>& res)
+{
+  if (batch.large) res += scal_alg.run(batch.indices, p, alpha);
+  else             bnl::run_segmented(batch.indices, batch.offsets, p, res);
+}
+
+class Psel_worker_grouped : public Worker {
+public:
+  // input
+  const std::vector<group_batch>& batches;
+  ppref p;
+  double alpha;
+  uint64_t seed; // each batch uses its own stream
+  
+  std::vector<std::vector<int>> results;
+  
+  Psel_worker_grouped(const std::vector<group_batch>& batches, ppref p, double alpha, uint64_t seed) :
+    batches(batches), p(p), alpha(alpha), seed(seed), results(batches.size()) {}
+  
+  void operator()(std::size_t begin, std::size_t end)
+  {
+    for (std::size_t k = begin; k < end; k++) {
+      scalagon scal_alg(sampler(seed, k));
+      run_group_batch(batches[k], p, alpha, scal_alg, results[k]);
+    }
+  }
+};
+
 // --------------------------------------------------------------------------------------------------------------------------------
 
 // Parallel grouped preference selection
@@ -128,32 +238,84 @@ NumericVector grouped_pref_sel_impl(const List& indices, const DataFrame& scores
 
   if (N > 1) { // parallel case
   
-    // Compose indices
-    std::vector<std::vector<int>> vs(nind);
-    std::vector<std::vector<int>> samples_ind(nind);
-    for (int i = 0; i < nind; i++) {
-      vs[i] = as<std::vector<int>>(indices[i]);
-      samples_ind[i] = get_sample(vs[i].size()); // Sample indices for this partition
-    }
-  
-    // Create worker
-    Psel_worker worker(vs, p, nind, alpha, samples_ind); 
+    // Compose batches of contiguous groups, about N batches of small groups
+    NumericVector col1 = scores[0];
+    const int max_tuples = std::max(1, static_cast<int>(std::ceil(1.0 * col1.size() / N)));
+    const std::vector<group_batch> batches = get_group_batches(indices, max_tuples);
+    const int nbatches = batches.size();
     
-    // Execute parallel
-    parallelFor(0, nind, worker);
+    // Create worker and execute parallel, large groups are sampled in the workers
+    Psel_worker_grouped worker(batches, p, alpha, sampler::seed_from_r()); 
+    interrupt::parallel_for(0, nbatches, worker);
     
     // Clue together
-    for (int i = 0; i < nind; i++) res += worker.results[i];
+    for (int k = 0; k < nbatches; k++) res += worker.results[k];
     
   } else { // non parallel case
   
     scalagon scal_alg;
+    
+    // All consecutive small groups are evaluated in one batch
+    for (const group_batch& batch : get_group_batches(indices, std::numeric_limits<int>::max())) {
+      run_group_batch(batch, p, alpha, scal_alg, res);
+    }
+  }
+  
+  return NumericVector(res.begin(), res.end());
+}
+
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
+// Approximate preference selection (epsilon-Skyline), BNL/Scalagon on the boxes of the tuples
+// subdivide the representatives of the boxes in N parts
+
+// [[Rcpp::export]]
+NumericVector pref_select_eps_impl(const DataFrame& scores, const List& serial_pref, const NumericVector& eps, bool relative, int N, double alpha)
+{
+  NumericVector col1 = scores[0];
+  const int ntuples = col1.size();
+  if (ntuples == 0) return NumericVector();
+  
+  const ppref p = CreatePreference(serial_pref, scores);
+  
+  std::vector<int> all(ntuples);
+  for (int i = 0; i < ntuples; i++) all[i] = i;
+  
+  epsilon_grid grid;
+  if (!grid.init(all, p, as<std::vector<double>>(eps), relative)) {
+    stop("Approximate Skylines (epsilon) are only supported for Pareto compositions of base preferences!");
+  }
+  const ppref bp = grid.box_pref();
+  const std::vector<int>& v = grid.representatives();
+  const int nv = v.size();
+  
+  scalagon scal_alg;
+  std::vector<int> res;
   
-    for (int i = 0; i < nind; i++) {
-      std::vector<int> group_indices = as<std::vector<int>>(indices[i]);
-      res += scal_alg.run(group_indices, p, alpha);
+  if (N == 1 || nv < 2 * N) {
+    
+    res = scal_alg.run(v, bp, alpha);
+    
+  } else {
+    
+    // Contiguous partitions of the representatives
+    const int tuples_part = std::ceil(1.0 * nv / N);
+    const int N_parts = std::ceil(1.0 * nv / tuples_part);
+    std::vector<std::vector<int>> vs(N_parts);
+    for (int k = 0; k < N_parts; k++) {
+      vs[k] = std::vector<int>(v.begin() + k * tuples_part, v.begin() + std::min(nv, (k + 1) * tuples_part));
     }
+    
+    // No filter points, the representatives are already one tuple per box
+    const std::vector<int> fpoints;
+    Psel_worker worker(vs, bp, N_parts, alpha, sampler::seed_from_r(), fpoints);
+    interrupt::parallel_for(0, N_parts, worker);
+    
+    for (int k = 0; k < N_parts; k++) res += worker.results[k];
+    res = scal_alg.run(res, bp, alpha);
   }
   
+  std::sort(res.begin(), res.end());
   return NumericVector(res.begin(), res.end());
 }
@@ -0,0 +1,68 @@
+#include "scalagon.h" // Includes BNL, SFS, pref classes and Scalagon
+
+#include <chrono>
+
+using namespace Rcpp;
+
+// Progressive preference selection
+// --------------------------------
+
+// Maxima are passed in chunks to the callback as soon as they are confirmed (presorting via SFS).
+// Runs in the main thread, as the callback is an R function.
+// Stops after timeout seconds (if timeout > 0), if the callback returns FALSE or at a user interrupt.
+
+// [[Rcpp::export]]
+List pref_select_progressive_impl(const DataFrame& scores, const List& serial_pref, double alpha,
+                                  int chunk_size, double timeout, Nullable<Function> callback)
+{
+  NumericVector col1 = scores[0];
+  const int ntuples = col1.size();
+  
+  std::vector<int> res;
+  if (ntuples == 0) return List::create(Named("index") = NumericVector(), Named("complete") = true);
+  
+  const ppref p = CreatePreference(serial_pref, scores);
+  
+  std::vector<int> v(ntuples);
+  for (int i = 0; i < ntuples; i++) v[i] = i;
+  
+  // Collect chunk and pass it to the callback (with R indices starting at 1)
+  auto emit = [&](const std::vector<int>& chunk) -> bool {
+    res += chunk;
+    if (callback.isNull()) return true;
+    NumericVector r_chunk(chunk.size());
+    for (std::size_t k = 0; k < chunk.size(); k++) r_chunk[k] = chunk[k] + 1;
+    SEXP ret = Function(callback.get())(r_chunk);
+    // only an explicit FALSE stops the evaluation
+    return !(Rf_isLogical(ret) && Rf_length(ret) == 1 && LOGICAL(ret)[0] == FALSE);
+  };
+  
+  // Check timeout and user interrupts (a user interrupt returns the maxima found so far)
+  const auto start = std::chrono::steady_clock::now();
+  auto proceed = [&]() -> bool {
+    if (interrupt::pending()) return false;
+    if (timeout <= 0) return true;
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() < timeout;
+  };
+  
+  bool complete = true;
+  
+  sfs sfs_alg;
+  if (sfs_alg.init(v, p)) {
+    complete = sfs_alg.run_progressive(v, p, chunk_size, emit, proceed);
+  } else {
+    // No presorting possible (e.g., union preference) - calculate all maxima at once and emit them in chunks
+    scalagon scal_alg;
+    std::vector<int> all_res = scal_alg.run(v, p, alpha);
+    for (std::size_t k = 0; k < all_res.size(); k += chunk_size) {
+      const std::size_t k_end = std::min(all_res.size(), k + chunk_size);
+      if (!emit(std::vector<int>(all_res.begin() + k, all_res.begin() + k_end))) {
+        complete = k_end == all_res.size();
+        break;
+      }
+    }
+  }
+  
+  return List::create(Named("index") = NumericVector(res.begin(), res.end()), Named("complete") = complete);
+}
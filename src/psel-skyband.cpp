@@ -0,0 +1,135 @@
+// [[Rcpp::depends(RcppParallel)]]
+#include <RcppParallel.h>
+using namespace RcppParallel;
+
+#include "scalagon.h" // Includes BNL, pref classes and Scalagon
+
+#include <algorithm>
+
+using namespace Rcpp;
+
+// k-skyband
+// ---------
+
+// The k-skyband contains the tuples dominated by less than k other tuples (the 1-skyband is the Skyline).
+// Tuples with a lower bound of the level > k from the Scalagon lattice have at least k dominators (a chain of
+// dominating tuples) and are discarded before BNL.
+// In the parallel case the local k-skybands of the partitions are a superset of the k-skyband,
+// the dominance counts are calculated afterwards within the union of the local k-skybands.
+
+class Skyband_worker : public Worker {
+public:
+  const std::vector<std::vector<int>>& vs;
+  const ppref& p;
+  const int k;
+  std::vector<std::vector<int>> results;
+
+  Skyband_worker(const std::vector<std::vector<int>>& vs, const ppref& p, int k) :
+    vs(vs), p(p), k(k), results(vs.size()) {}
+
+  void operator()(std::size_t begin, std::size_t end)
+  {
+    for (std::size_t part = begin; part < end; part++) {
+      for (const std::pair<int, int>& res : bnl::run_skyband(vs[part], p, k)) results[part].push_back(res.second);
+    }
+  }
+};
+
+// Dominance counts of the candidates within all candidates (stops counting at k)
+class Domcount_worker : public Worker {
+public:
+  const std::vector<int>& cand;
+  const ppref& p;
+  const int k;
+  const int cand_part;
+  std::vector<int>& counts;
+
+  Domcount_worker(const std::vector<int>& cand, const ppref& p, int k, int cand_part, std::vector<int>& counts) :
+    cand(cand), p(p), k(k), cand_part(cand_part), counts(counts) {}
+
+  void operator()(std::size_t begin, std::size_t end)
+  {
+    const int ncand = cand.size();
+    for (std::size_t part = begin; part < end; part++) {
+      const int from = part * cand_part;
+      const int to = std::min(ncand, static_cast<int>(part + 1) * cand_part);
+      for (int i = from; i < to; i++) {
+        if (interrupt::requested()) return; // result is discarded
+        int count = 0;
+        for (int j = 0; j < ncand && count < k; j++) {
+          if (p->cmp(cand[j], cand[i])) count++;
+        }
+        counts[i] = count;
+      }
+    }
+  }
+};
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
+// k-skyband with dominance counts, ordered by the tuple indices (C indices)
+// [[Rcpp::export]]
+DataFrame psel_skyband_impl(const DataFrame& scores, List serial_pref, int k, double alpha, int N)
+{
+  NumericVector col1 = scores[0];
+  const int ntuples = col1.size();
+  if (ntuples == 0) return DataFrame::create(Named(".index") = NumericVector(), Named(".domcount") = NumericVector());
+
+  // De-Serialize preference
+  const ppref p = CreatePreference(serial_pref, scores);
+
+  // Scalagon prefiltering (all tuples are kept if Scalagon is not applicable)
+  std::vector<int> v(ntuples);
+  for (int i = 0; i < ntuples; i++) v[i] = i;
+  scalagon scal_alg;
+  const std::vector<int> bounds = scal_alg.level_bounds(v, p, alpha);
+  if (!bounds.empty()) {
+    std::vector<int> filtered;
+    for (int i : v) if (bounds[i] <= k) filtered.push_back(i);
+    std::swap(v, filtered);
+  }
+  const int nv = v.size();
+
+  pair_vector res;
+  if (N == 1 || nv < 2 * N) {
+
+    res = bnl::run_skyband(v, p, k);
+
+  } else {
+
+    // Local k-skybands of the partitions
+    const int tuples_part = std::ceil(1.0 * nv / N);
+    const int N_parts = std::ceil(1.0 * nv / tuples_part);
+    std::vector<std::vector<int>> vs(N_parts);
+    for (int i = 0; i < nv; i++) vs[i / tuples_part].push_back(v[i]);
+
+    Skyband_worker sb_worker(vs, p, k);
+    interrupt::parallel_for(0, N_parts, sb_worker);
+
+    std::vector<int> cand;
+    for (const std::vector<int>& local : sb_worker.results) cand += local;
+
+    // Dominance counts within the candidates
+    const int ncand = cand.size();
+    std::vector<int> counts(ncand);
+    if (ncand > 0) {
+      const int cand_part = std::ceil(1.0 * ncand / N);
+      const int N_cand_parts = std::ceil(1.0 * ncand / cand_part);
+      Domcount_worker dc_worker(cand, p, k, cand_part, counts);
+      interrupt::parallel_for(0, N_cand_parts, dc_worker);
+    }
+
+    for (int i = 0; i < ncand; i++) {
+      if (counts[i] < k) res.push_back(std::pair<int, int>(counts[i], cand[i]));
+    }
+  }
+
+  std::sort(res.begin(), res.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.second < b.second; });
+
+  NumericVector index(res.size()), domcount(res.size());
+  for (std::size_t i = 0; i < res.size(); i++) {
+    index[i] = res[i].second;
+    domcount[i] = res[i].first;
+  }
+  return DataFrame::create(Named(".index") = index, Named(".domcount") = domcount);
+}
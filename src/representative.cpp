@@ -0,0 +1,166 @@
+#include "pref-classes.h"
+#include "representative.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+using namespace Rcpp;
+
+representatives::representatives(const std::vector<std::vector<double>>& cols) : m_cols(cols)
+{
+  m_ntuples = cols.empty() ? 0 : cols[0].size();
+  m_dist = std::vector<double>(m_ntuples, INFINITY);
+
+  // Normalize to [0, 1], NA values are mapped to 1
+  for (std::vector<double>& col : m_cols) {
+    double lo = INFINITY, hi = -INFINITY;
+    for (double x : col) {
+      if (std::isnan(x)) continue;
+      lo = std::min(lo, x);
+      hi = std::max(hi, x);
+    }
+    for (double& x : col) x = std::isnan(x) ? 1 : ((hi > lo) ? (x - lo) / (hi - lo) : 0);
+  }
+
+  // About 8 tuples per cell (on uniformly distributed tuples)
+  m_grid = std::max(1, static_cast<int>(std::pow(m_ntuples / 8.0, 1.0 / std::max(1, dim()))));
+
+  std::unordered_map<int64_t, int> cell_ids;
+  for (int i = 0; i < m_ntuples; i++) {
+    std::vector<int> lower(dim());
+    int64_t id = 0;
+    for (int k = 0; k < dim(); k++) {
+      lower[k] = std::min(m_grid - 1, static_cast<int>(m_cols[k][i] * m_grid));
+      id = id * m_grid + lower[k];
+    }
+    auto it = cell_ids.emplace(id, m_cells.size()).first;
+    if (it->second == static_cast<int>(m_cells.size())) {
+      m_cells.push_back(cell());
+      m_cells.back().lower = lower;
+    }
+    m_cells[it->second].tuples.push_back(i);
+  }
+}
+
+double representatives::dist(int i, int j) const
+{
+  double res = 0;
+  for (int k = 0; k < dim(); k++) {
+    const double d = m_cols[k][i] - m_cols[k][j];
+    res += d * d;
+  }
+  return res;
+}
+
+double representatives::min_dist(int i, const cell& c) const
+{
+  double res = 0;
+  for (int k = 0; k < dim(); k++) {
+    const double lo = 1.0 * c.lower[k] / m_grid, hi = 1.0 * (c.lower[k] + 1) / m_grid;
+    const double x = m_cols[k][i];
+    const double d = (x < lo) ? lo - x : ((x > hi) ? x - hi : 0);
+    res += d * d;
+  }
+  return res;
+}
+
+void representatives::add_center(int i)
+{
+  for (cell& c : m_cells) {
+    // No tuple of the cell is closer to i than to its nearest center (the cell of i is never skipped)
+    if (c.max_dist < min_dist(i, c)) continue;
+
+    c.max_dist = -1;
+    c.farthest = -1;
+    for (int j : c.tuples) {
+      if (j == i) {
+        m_dist[j] = -1;
+      } else if (m_dist[j] >= 0) {
+        m_dist[j] = std::min(m_dist[j], dist(i, j));
+      }
+      if (m_dist[j] > c.max_dist) {
+        c.max_dist = m_dist[j];
+        c.farthest = j;
+      }
+    }
+  }
+}
+
+std::vector<int> representatives::select(int k)
+{
+  std::vector<int> res;
+  if (m_ntuples == 0 || k <= 0) return res;
+  m_dist.assign(m_ntuples, INFINITY);
+  for (cell& c : m_cells) c.max_dist = INFINITY;
+
+  // Start with the tuple farthest from the center of all tuples (an extreme tuple)
+  std::vector<double> mean(dim());
+  for (int d = 0; d < dim(); d++) {
+    for (double x : m_cols[d]) mean[d] += x / m_ntuples;
+  }
+  int next = 0;
+  double next_dist = -1;
+  for (int i = 0; i < m_ntuples; i++) {
+    double d2 = 0;
+    for (int d = 0; d < dim(); d++) d2 += (m_cols[d][i] - mean[d]) * (m_cols[d][i] - mean[d]);
+    if (d2 > next_dist) {
+      next = i;
+      next_dist = d2;
+    }
+  }
+
+  // Farthest-first traversal, the farthest tuple is the farthest one of all cells
+  while (next != -1) {
+    res.push_back(next);
+    add_center(next);
+    if (static_cast<int>(res.size()) >= k) break;
+
+    next = -1;
+    next_dist = -1;
+    for (const cell& c : m_cells) {
+      if (c.max_dist > next_dist) {
+        next = c.farthest;
+        next_dist = c.max_dist;
+      }
+    }
+  }
+
+  return res;
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
+// Leaves of the preference tree, their values are the coordinates of the tuples (the direction is irrelevant for distances)
+static void add_leaves(const ppref& p, std::vector<std::shared_ptr<leafpref>>& leaves)
+{
+  if (std::shared_ptr<complexpref> cpref = std::dynamic_pointer_cast<complexpref>(p)) {
+    add_leaves(cpref->p1, leaves);
+    add_leaves(cpref->p2, leaves);
+  } else if (std::shared_ptr<reversepref> rpref = std::dynamic_pointer_cast<reversepref>(p)) {
+    add_leaves(rpref->p, leaves);
+  } else if (std::shared_ptr<leafpref> lpref = std::dynamic_pointer_cast<leafpref>(p)) {
+    leaves.push_back(lpref);
+  }
+}
+
+// k representative tuples of the given tuples (C indices, e.g. the Skyline) in the order of their selection
+// [[Rcpp::export]]
+NumericVector representative_impl(const DataFrame& scores, const List& serial_pref, const NumericVector& indices, int k)
+{
+  // Values of the base preferences, e.g., levels of layered preferences or distances of around/between preferences
+  std::vector<std::shared_ptr<leafpref>> leaves;
+  add_leaves(CreatePreference(serial_pref, scores), leaves);
+  
+  std::vector<std::vector<double>> cols(leaves.size(), std::vector<double>(indices.size()));
+  for (std::size_t d = 0; d < cols.size(); d++) {
+    for (int i = 0; i < indices.size(); i++) cols[d][i] = leaves[d]->value(indices[i]);
+  }
+
+  representatives repr(cols);
+  std::vector<int> sel = repr.select(k);
+
+  NumericVector res(sel.size());
+  for (std::size_t i = 0; i < sel.size(); i++) res[i] = indices[sel[i]];
+  return res;
+}
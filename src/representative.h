@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+// Representative Skyline
+// ----------------------
+
+// Selects k of the given tuples which are spread over the score space, by the greedy farthest-first traversal
+// (2-approximation of the k-center problem, see T. F. Gonzalez, "Clustering to minimize the maximum intercluster
+// distance", Theoretical Computer Science 38, 1985), where each score column is normalized to [0, 1].
+//
+// The tuples are stored in a uniform grid. After a new center is chosen, only the cells which may contain
+// a tuple closer to the new center than to all previous centers are updated.
+
+class representatives
+{
+public:
+
+  // Score columns of the tuples (cols[k][i] for the i-th tuple), each one is normalized
+  representatives(const std::vector<std::vector<double>>& cols);
+
+  // Up to k tuples (positions in cols) in the order of their selection, i.e., each prefix is a representative set
+  std::vector<int> select(int k);
+
+private:
+
+  struct cell
+  {
+    std::vector<int> tuples;
+    std::vector<int> lower;   // grid coordinates
+    double max_dist = -1;     // maximal (squared) distance of a tuple to its nearest center, -1 if all are centers
+    int farthest = -1;
+  };
+
+  std::vector<std::vector<double>> m_cols;
+  std::vector<double> m_dist;
+  std::vector<cell> m_cells;
+  int m_ntuples;
+  int m_grid;
+
+  int dim() const { return m_cols.size(); }
+
+  double dist(int i, int j) const;
+
+  // Squared distance between a tuple and the box of a cell
+  double min_dist(int i, const cell& c) const;
+
+  void add_center(int i);
+};
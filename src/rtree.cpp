@@ -0,0 +1,183 @@
+#include "rtree.h"
+#include "interrupt.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+using namespace Rcpp;
+
+rtree::rtree(const std::vector<std::vector<double>>& cols) : m_cols(cols)
+{
+  const int ntuples = cols.empty() ? 0 : cols[0].size();
+  m_order = std::vector<int>(ntuples);
+  for (int i = 0; i < ntuples; i++) m_order[i] = i;
+  if (ntuples == 0) return;
+
+  str_sort(0, ntuples, 0);
+
+  // Leaves, followed by the levels of inner nodes up to a single root
+  int first = add_level(0, ntuples, true);
+  int last = m_nodes.size();
+  while (last - first > 1) {
+    const int next = add_level(first, last, false);
+    first = next;
+    last = m_nodes.size();
+  }
+}
+
+void rtree::str_sort(int from, int to, int k)
+{
+  const std::vector<double>& col = m_cols[k];
+  std::sort(m_order.begin() + from, m_order.begin() + to, [&col](int i, int j) { return col[i] < col[j]; });
+  if (k == dim() - 1) return;
+
+  // Number of slabs for the remaining dimensions
+  const int n = to - from;
+  const double nleaves = std::ceil(1.0 * n / node_capacity);
+  const int slab_size = node_capacity * static_cast<int>(std::ceil(nleaves / std::ceil(std::pow(nleaves, 1.0 / (dim() - k)))));
+  for (int s = from; s < to; s += slab_size) str_sort(s, std::min(to, s + slab_size), k + 1);
+}
+
+int rtree::add_level(int from, int to, bool leaf)
+{
+  const int first = m_nodes.size();
+  for (int c = from; c < to; c += node_capacity) {
+    node nd;
+    nd.first = c;
+    nd.count = std::min(to, c + node_capacity) - c;
+    nd.leaf = leaf;
+    nd.lo = std::vector<double>(dim(), INFINITY);
+    nd.hi = std::vector<double>(dim(), -INFINITY);
+    for (int e = c; e < c + nd.count; e++) {
+      for (int k = 0; k < dim(); k++) {
+        if (leaf) {
+          const double val = m_cols[k][m_order[e]];
+          nd.lo[k] = std::min(nd.lo[k], val);
+          nd.hi[k] = std::max(nd.hi[k], val);
+        } else {
+          nd.lo[k] = std::min(nd.lo[k], m_nodes[e].lo[k]);
+          nd.hi[k] = std::max(nd.hi[k], m_nodes[e].hi[k]);
+        }
+      }
+    }
+    m_nodes.push_back(nd);
+  }
+  return first;
+}
+
+std::vector<std::pair<int, int>> rtree::skyline(const std::vector<int>& dims, const std::vector<int>& dirs, int top_level) const
+{
+  std::vector<std::pair<int, int>> res;
+  if (m_nodes.empty()) return res;
+  const int qdim = dims.size();
+
+  // Found tuples by their (oriented) values
+  std::vector<std::vector<double>> found_vals;
+  std::vector<int> found_levels;
+
+  // Level of a point: 1 + maximal level of its dominators, 0 if a dominator is in top_level
+  auto get_level = [&](const std::vector<double>& pt, bool corner) {
+    int level = 1;
+    const int nfound = found_vals.size();
+    for (int f = 0; f < nfound; f++) {
+      if (found_levels[f] < level) continue; // cannot increase the level
+      const std::vector<double>& u = found_vals[f];
+      bool better = false, worse = false;
+      for (int k = 0; k < qdim && !worse; k++) {
+        if (u[k] < pt[k]) better = true;
+        else if (u[k] > pt[k]) worse = true;
+      }
+      if (better && !worse) {
+        if (found_levels[f] == top_level) return 0;
+        level = found_levels[f] + 1;
+      }
+    }
+    return corner ? 1 : level;
+  };
+
+  // Oriented values of a tuple / best corner of a node
+  auto tuple_vals = [&](int i) {
+    std::vector<double> pt(qdim);
+    for (int k = 0; k < qdim; k++) pt[k] = dirs[k] * m_cols[dims[k]][i];
+    return pt;
+  };
+  auto corner_vals = [&](int nd) {
+    std::vector<double> pt(qdim);
+    for (int k = 0; k < qdim; k++) pt[k] = dirs[k] > 0 ? m_nodes[nd].lo[dims[k]] : -m_nodes[nd].hi[dims[k]];
+    return pt;
+  };
+  auto sum = [](const std::vector<double>& pt) {
+    double res = 0;
+    for (double val : pt) res += val;
+    return res;
+  };
+
+  // Heap of <<sum, values>, <is tuple, node/tuple index>>, smallest sum first.
+  // Equal sums (e.g. by rounding) are ordered lexicographically by the values, a dominator is also lexicographically smaller
+  using entry = std::pair<std::pair<double, std::vector<double>>, std::pair<bool, int>>;
+  auto make_entry = [&](std::vector<double>&& pt, bool is_tuple, int ind) {
+    const double s = sum(pt);
+    return entry(std::make_pair(s, std::move(pt)), std::make_pair(is_tuple, ind));
+  };
+  std::priority_queue<entry, std::vector<entry>, std::greater<entry>> heap;
+  const int root = m_nodes.size() - 1;
+  heap.push(make_entry(corner_vals(root), false, root));
+
+  // Interval for checking user interrupts (this runs in the main thread)
+  const int check_interval = 10000;
+  for (int iter = 1; !heap.empty(); iter++) {
+    if (iter % check_interval == 0 && interrupt::pending()) throw Rcpp::internal::InterruptedException();
+    const entry top = heap.top();
+    heap.pop();
+
+    if (top.second.first) { // tuple
+      const int i = top.second.second;
+      const std::vector<double>& pt = top.first.second;
+      const int level = get_level(pt, false);
+      if (level == 0) continue;
+      found_vals.push_back(pt);
+      found_levels.push_back(level);
+      res.push_back(std::make_pair(level, i));
+    } else { // node, skipped if all entries are dominated by the last requested level
+      const node& nd = m_nodes[top.second.second];
+      if (get_level(top.first.second, true) == 0) continue;
+      for (int e = nd.first; e < nd.first + nd.count; e++) {
+        if (nd.leaf) heap.push(make_entry(tuple_vals(m_order[e]), true, m_order[e]));
+        else         heap.push(make_entry(corner_vals(e), false, e));
+      }
+    }
+  }
+
+  std::sort(res.begin(), res.end());
+  return res;
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
+// Create the R-tree on the given numeric columns (finite values only, see psel.rtree.index)
+// [[Rcpp::export]]
+SEXP rtree_index_impl(const DataFrame& raw)
+{
+  std::vector<std::vector<double>> cols(raw.size());
+  for (std::size_t k = 0; k < cols.size(); k++) cols[k] = as<std::vector<double>>(as<NumericVector>(raw[k]));
+  return XPtr<rtree>(new rtree(cols), true);
+}
+
+// Tuples (C indices) up to level top_level of the Pareto preference on the columns dims (C indices),
+// which are minimized (dirs = 1) or maximized (dirs = -1)
+// [[Rcpp::export]]
+DataFrame rtree_skyline_impl(SEXP index, const IntegerVector& dims, const IntegerVector& dirs, int top_level)
+{
+  XPtr<rtree> idx(index);
+  if (idx.get() == 0) stop("The index is not available anymore, create a new one!");
+
+  const std::vector<std::pair<int, int>> res = idx->skyline(as<std::vector<int>>(dims), as<std::vector<int>>(dirs), top_level);
+
+  NumericVector index_res(res.size()), level(res.size());
+  for (std::size_t i = 0; i < res.size(); i++) {
+    index_res[i] = res[i].second;
+    level[i] = res[i].first;
+  }
+  return DataFrame::create(Named(".index") = index_res, Named(".level") = level);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Rcpp.h>
+#include <vector>
+
+// R-tree for Skyline queries
+// --------------------------
+
+// Static R-tree over numeric columns, bulk loaded by Sort-Tile-Recursive (STR),
+// see "STR: A Simple and Efficient Algorithm for R-Tree Packing", S. Leutenegger, M. Lopez, J. Edgington, ICDE 1997.
+//
+// Queries are Pareto preferences on any subset of the columns, each minimized (dir = 1) or maximized (dir = -1),
+// evaluated by Branch and Bound Skyline (BBS), see "Progressive Skyline Computation in Database Systems",
+// D. Papadias, Y. Tao, G. Fu, B. Seeger, TODS 2005.
+// Nodes and tuples are visited in ascending order of the sum of their (best) values (and lexicographically for equal sums),
+// hence all dominators of a tuple are visited before the tuple itself (this requires finite values).
+// A node is skipped if its best corner is dominated by a tuple in the last requested level.
+
+class rtree
+{
+public:
+
+  rtree(const std::vector<std::vector<double>>& cols);
+
+  int dim() const { return m_cols.size(); }
+
+  // Tuples up to level top_level with their levels (<level, tuple index>), ordered by level and tuple index
+  std::vector<std::pair<int, int>> skyline(const std::vector<int>& dims, const std::vector<int>& dirs, int top_level) const;
+
+  // maximal number of entries of a node
+  static const int node_capacity = 32;
+
+private:
+
+  struct node
+  {
+    std::vector<double> lo, hi; // bounding box
+    int first, count;           // children (nodes or positions in m_order)
+    bool leaf;
+  };
+
+  std::vector<std::vector<double>> m_cols;
+  std::vector<int> m_order; // tuples in the order of the leaves
+  std::vector<node> m_nodes; // root is the last node
+
+  // STR ordering of m_order[from, to) starting with column k
+  void str_sort(int from, int to, int k);
+
+  // Add a level of nodes over the entries [from, to) of the level below, returns the first new node
+  int add_level(int from, int to, bool leaf);
+};
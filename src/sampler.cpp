@@ -0,0 +1,33 @@
+#include "sampler.h"
+
+uint64_t sampler::seed_from_r()
+{
+  // Two draws with 32 random bits each
+  const uint64_t high = static_cast<uint64_t>(unif_rand() * 4294967296.0);
+  const uint64_t low = static_cast<uint64_t>(unif_rand() * 4294967296.0);
+  return (high << 32) ^ low;
+}
+
+// Finalizer of splitmix64
+static inline uint64_t mix(uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+uint64_t sampler::hash(uint64_t seed, uint64_t stream, uint64_t counter)
+{
+  return mix(mix(seed ^ mix(stream + 0x9e3779b97f4a7c15ULL)) + counter * 0x9e3779b97f4a7c15ULL);
+}
+
+std::vector<int> sampler::sample(int ntuples, int size)
+{
+  std::vector<int> res;
+  res.reserve(size);
+  for (int i = 0; i < size; i++) res.push_back(next_int(ntuples));
+  return res;
+}
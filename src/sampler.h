@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Rcpp.h>
+#include <cstdint>
+
+// Counter based random numbers
+// ----------------------------
+
+// The k-th number of a stream is a hash of (seed, stream, k), hence sampling needs no shared state
+// and can be done inside the worker threads. The seed is drawn once from the RNG of R (in the main thread),
+// such that the samples are reproducible with set.seed. Each partition/group uses its own stream.
+
+class sampler
+{
+public:
+  
+  sampler(uint64_t seed = 0, uint64_t stream = 0) : m_seed(seed), m_stream(stream) {}
+  
+  // Draw a seed from the RNG of R, must be called from the main thread!
+  static uint64_t seed_from_r();
+  
+  // Next random number of the stream
+  uint64_t next() { return hash(m_seed, m_stream, m_counter++); }
+  
+  // Uniformly distributed integer in [0, n)
+  int next_int(int n) { return static_cast<int>((next() >> 11) * (1.0 / 9007199254740992.0) * n); }
+  
+  // Sample (with replacement) of size positions in [0, ntuples)
+  std::vector<int> sample(int ntuples, int size);
+  
+private:
+  
+  uint64_t m_seed;
+  uint64_t m_stream;
+  uint64_t m_counter = 0;
+  
+  static uint64_t hash(uint64_t seed, uint64_t stream, uint64_t counter);
+};
@@ -2,18 +2,11 @@
 
 // There is no scalagon_implementation here, this is done in psel-par.cpp and psel-par-top.cpp
 
-// Helper for getting random numbers (R specific),
-// should not be in the worker thread, as this accesses the R API (unif_rand()).
-std::vector<int> get_sample(int ntuples)
+// Helper for getting random positions, can be called in the worker threads (see sampler)
+std::vector<int> get_sample(int ntuples, sampler& rng)
 {
   if (ntuples < scalagon::scalagon_min_tuples) return std::vector<int>(); // no sample needed, not enough tuples
-  std::vector<int> res;
-  res.reserve(scalagon::sample_size);
-  ntuples--;
-  for (int i = 0; i < scalagon::sample_size; i++) {
-    res.push_back(floor(ntuples * unif_rand()));
-  }
-  return res;
+  return rng.sample(ntuples, scalagon::sample_size(ntuples));
 }
 
 // --------------------------------------------------------------------------------------------------------------------------------
@@ -30,7 +23,9 @@ std::vector<int> get_sample(int ntuples)
 
 
 // Constructors / Destructors
-scalagon::scalagon(bool sample_precalc) : sample_precalc(sample_precalc) {}
+scalagon::scalagon() : m_seeded(false) {}
+
+scalagon::scalagon(const sampler& rng) : m_seeded(true), m_rng(rng) {}
 
 // Put all pareto/intersection preferences of a tree into a std::vector
 // Returns true if successful, false if not (found non-productpref), results are in m_prefs
@@ -40,8 +35,8 @@ bool scalagon::get_prefs(const ppref& p)
   std::shared_ptr<productpref> pref = std::dynamic_pointer_cast<productpref>(p); 
   
   if (pref == 0) { 
-    // Now we assume a scorepref
-    std::shared_ptr<scorepref> spref = std::dynamic_pointer_cast<scorepref>(p); 
+    // Now we assume a leaf (score or categorical preference)
+    std::shared_ptr<leafpref> spref = std::dynamic_pointer_cast<leafpref>(p); 
     if (spref != 0) {
       m_prefs.push_back(spref);
       return true;
@@ -60,7 +55,7 @@ std::vector<int> scalagon::run(const std::vector<int>& v, const ppref& p, double
   if (init(v, p, alpha)) { // return false if input does not suit
     
     // *** Domination phase
-    dominate(std::vector<int>(), p); // empty vecor - no index needed for non-topk Scalagon
+    dominate();
     
     // **** Filtering: Add all not dominated tuples to filtered result (outliers are already in, done by init!)
     const int scount = m_stuples_v.size();
@@ -94,32 +89,32 @@ flex_vector scalagon::run_topk(const std::vector<int>& v, const ppref& p, const
     else              return flex_vector(std::vector<int>(), bnl_alg.add_level(run(v, p, alpha), 1)); // ... WITH LEVELS, final_result_vector is empty
   }
   
+  // Bounded top-k: with presorting we can stop as soon as the top-k tuples are confirmed
+  if (sfs::is_bounded(ts)) {
+    sfs sfs_alg;
+    if (sfs_alg.init(v, p)) return sfs_alg.run_topk(v, p, ts, show_levels);
+  }
+  
   std::vector<int> final_result_vector;
   pair_vector final_result_pair_vector; // Pairs of level and tuple index
 
-  const int ntuples = v.size();  
-  if (show_levels) final_result_pair_vector.reserve(ntuples);
-  else             final_result_vector.reserve(ntuples);
-
   if (init(v, p, alpha)) { // use Scalagon
 
-    const int s_ind_count = m_stuples_v.size(); // Number of center tuples / scaled tuples (non-outliers), in the loop: tuples still in s_indices set
-
-    // Vectors for Std BNL, make pairs to store the s-index
-    pair_vector remainder_pairs;
-    pair_vector index_pairs;
-    remainder_pairs.reserve(ntuples);
-    index_pairs.reserve(ntuples);
-
-    // Add outliers to pair_vector
-    for (int u : m_filt_res) {
-      index_pairs.push_back(std::pair<int, int>(u, -1)); // outliers => they have no s-index
+    // *** Domination phase: lower bound of the level for each center tuple, calculated only once
+    const std::vector<int> depth = dominate_depth();
+    
+    // Center tuples grouped by their depth (v-numbers), they are not needed before their depth is reached
+    std::vector<std::vector<int>> depth_buckets;
+    const int scount = depth.size();
+    for (int i = 0; i < scount; i++) {
+      if (depth[i] > static_cast<int>(depth_buckets.size())) depth_buckets.resize(depth[i]);
+      depth_buckets[depth[i] - 1].push_back(v[m_stuples_v[i]]);
     }
-    m_filt_res.clear(); // this is not needed anymore!
     
-    // indices for scalagon
-    std::vector<int> s_indices(s_ind_count);
-    for (int i = 0; i < s_ind_count; i++) s_indices[i] = i;
+    // Outliers have no depth, they are candidates from the first level on
+    std::vector<int> index_vec;
+    std::vector<int> remainder;
+    std::swap(index_vec, m_filt_res);
 
     // Level and result set counter
     int nres = 0;
@@ -127,25 +122,14 @@ flex_vector scalagon::run_topk(const std::vector<int>& v, const ppref& p, const
 
     while (true) {
 
-      // *** Domination phase
-      dominate(s_indices, p);
-
-      // **** Filtering: Add all not dominated tuples to filtered result (outliers are already in!)
-      for (int cur_s_sind : s_indices) {
-        int btg_ind = get_index_tuples(cur_s_sind); // get from stuples [0,...,scount-1]
-        if (!m_btg[btg_ind]) {
-          // Add v-number and s-index to the index_pair std::vector
-          index_pairs.push_back(std::pair<int, int>(v[m_stuples_v[cur_s_sind]], cur_s_sind));
-        } else {
-          // not in Scalagon filtered tuples => add to remainder
-          remainder_pairs.push_back(std::pair<int, int>(v[m_stuples_v[cur_s_sind]], cur_s_sind));
-        }
+      // **** Filtering: Add all center tuples with depth = level to the remainder of the last level
+      if (level <= static_cast<int>(depth_buckets.size())) {
+        index_vec += depth_buckets[level - 1];
+        std::vector<int>().swap(depth_buckets[level - 1]); // this is not needed anymore!
       }
 
       // **** Run BNL on filtered set
-
-      // gets index_pairs and remainder_pairs as reference
-      pair_vector res = bnl_alg.run_remainder_paired(index_pairs, remainder_pairs, p);
+      std::vector<int> res = bnl_alg.run_remainder(index_vec, remainder, p);
 
       // increment counter
       const int rsize = res.size();
@@ -153,9 +137,9 @@ flex_vector scalagon::run_topk(const std::vector<int>& v, const ppref& p, const
       nres += rsize;
 
       // Add to final results
-      for (const std::pair<int,int>& u : res) {
-        if (show_levels) final_result_pair_vector.push_back(std::pair<int, int>(level, u.first));
-        else             final_result_vector     .push_back(u.first);
+      for (int u : res) {
+        if (show_levels) final_result_pair_vector.push_back(std::pair<int, int>(level, u));
+        else             final_result_vector     .push_back(u);
       }
 
       // ** Break?
@@ -163,22 +147,8 @@ flex_vector scalagon::run_topk(const std::vector<int>& v, const ppref& p, const
       level++;
 
       // ** Prepare for next step
-
-      index_pairs.clear();
-      s_indices.clear();
-
-      // Add all outliers from the remainder to index_pairs and all center-tuples to s_indices
-      // this are all subsets, hence there is enough space
-      // start with HIGHEST indices, as these are the better dominating tuples!
-      for (auto i = remainder_pairs.rbegin(); i != remainder_pairs.rend(); ++i) { 
-        if (i->second == -1) { //outlier => add directly to index_pairs
-          index_pairs.push_back(*i);
-        } else { // not outlier => first run scalagon, then add to index_pairs (at begin of loop)
-          s_indices.push_back(i->second);
-        }
-      }
-      
-      remainder_pairs.clear();
+      std::swap(index_vec, remainder);
+      remainder.clear();
     }
 
     // Cut in the top-k case
@@ -195,18 +165,52 @@ flex_vector scalagon::run_topk(const std::vector<int>& v, const ppref& p, const
 
 
 
+// Level bounds for estimations without running BNL
+std::vector<int> scalagon::level_bounds(const std::vector<int>& v, const ppref& p, double alpha)
+{
+  if (!init(v, p, alpha)) return std::vector<int>();
+  
+  std::vector<int> res(v.size(), 1); // outliers are not in the lattice
+  const std::vector<int> depth = dominate_depth();
+  const int scount = depth.size();
+  for (int i = 0; i < scount; i++) res[m_stuples_v[i]] = depth[i];
+  
+  return res;
+}
+
+std::vector<int> scalagon::cells() const
+{
+  // All tuples of v are either scaled or outliers
+  std::vector<int> res(m_stuples_v.size() + m_filt_res.size(), -1);
+  const int scount = m_stuples_v.size();
+  for (int i = 0; i < scount; i++) res[m_stuples_v[i]] = get_index_tuples(i);
+  return res;
+}
+
+bool scalagon::cell_leq(int c1, int c2) const
+{
+  // Coordinates are the digits of the index in the mixed radix given by the scale factors
+  for (int k = 0; k < m_dim; k++) {
+    if (c1 % m_scale_fct[k] > c2 % m_scale_fct[k]) return false;
+    c1 /= m_scale_fct[k];
+    c2 /= m_scale_fct[k];
+  }
+  return true;
+}
+
+
 // ------------------------------------------------------------------------------------------------------------------------------------------------------
 
 // Helper functions for prefiltering
 
-int scalagon::get_index_tuples(int ind)
+int scalagon::get_index_tuples(int ind) const
 {
   int res = m_stuples[0][ind];
   for (int i = 1; i < m_dim; i++) res += m_weights[i] * m_stuples[i][ind];
   return res;
 }
 
-int scalagon::get_index_pt(const std::vector<int>& pt)
+int scalagon::get_index_pt(const std::vector<int>& pt) const
 {
   int res = pt[0];
   for (int i = 1; i < m_dim; i++) res += m_weights[i] * pt[i];
@@ -275,8 +279,8 @@ std::vector<int> scalagon::iterated_scaling(const std::vector<int>& domain_size,
 bool scalagon::init(const std::vector<int>& v, const ppref& p, double alpha)
 {
   // consts for sampling
-  const int lower_quantile = 19; // 2 % and 98 % quantile
-  const int upper_quantile = 979;
+  const double lower_quantile_fct = 0.02; // 2 % and 98 % quantile
+  const double upper_quantile_fct = 0.98;
   const double add_spread_fct = 0.2; // Add to lower/upper quantiles 
   
   // **** Get preferences / preliminary checks
@@ -293,7 +297,14 @@ bool scalagon::init(const std::vector<int>& v, const ppref& p, double alpha)
   m_dim = m_prefs.size();
   
   // Calc samples
-  if (!sample_precalc) sample_ind = get_sample(ntuples);
+  if (!m_seeded) {
+    m_rng = sampler(sampler::seed_from_r());
+    m_seeded = true;
+  }
+  m_sample = get_sample(ntuples, m_rng);
+  const int nsample = m_sample.size();
+  const int lower_quantile = lower_quantile_fct * (nsample - 1);
+  const int upper_quantile = upper_quantile_fct * (nsample - 1);
   
   // lower and upper bounds for the "center" where most tuples are expected
   std::vector<double> upper_bound(m_dim);
@@ -303,7 +314,7 @@ bool scalagon::init(const std::vector<int>& v, const ppref& p, double alpha)
   std::vector<int> est_domain_size(m_dim);
   
   // Calculate upper/lower bound by considering the sample in each dimension
-  // Note that sample_ind is already calculated (is given to the constructor)
+  // Note that m_sample is already calculated
   for (int k = 0; k < m_dim; k++) {
     
     // Set for calculating domain size
@@ -311,11 +322,11 @@ bool scalagon::init(const std::vector<int>& v, const ppref& p, double alpha)
     std::set<double>::iterator it;
     
     // Vector for calculating quantiles
-    std::vector<double> sample(sample_size);
+    std::vector<double> sample(nsample);
     
     // Pick sample
-    for (int i = 0; i < sample_size; i++) {
-      double val = m_prefs[k]->data[v[sample_ind[i]]];
+    for (int i = 0; i < nsample; i++) {
+      double val = m_prefs[k]->value(v[m_sample[i]]);
       sample[i] = val;
       sample_set.insert(val);
     }
@@ -326,9 +337,18 @@ bool scalagon::init(const std::vector<int>& v, const ppref& p, double alpha)
     lower_bound[k] = sample[lower_quantile] - add_dist;
     upper_bound[k] = sample[upper_quantile] + add_dist;
     
+    // Domain size is known for categorical preferences (of the whole data set, v may be a partition or a group
+    // which is constant in this dimension, then the scaling would divide by zero)
+    const int known_dom_size = m_prefs[k]->domain_size();
+    if (known_dom_size > 0) {
+      if (sample_set.size() == 1) return false; // see below
+      est_domain_size[k] = known_dom_size;
+      continue;
+    }
+    
     // Heuristic for domain size estimation: distinct sample set is larger then 3/4 of sample size => Assume continuous domain
     int dom_size = sample_set.size();
-    if (dom_size > 3 * sample_size / 4) {
+    if (dom_size > 3 * nsample / 4) {
       est_domain_size[k] = ntuples; // Asumme domain size is "very large"
     } else {
       est_domain_size[k] = dom_size; // Small dom_size: Assume dom_size is the correct domain size
@@ -345,7 +365,6 @@ bool scalagon::init(const std::vector<int>& v, const ppref& p, double alpha)
   // ***** Run scalagon with given scaling
   
   m_filt_res.clear();
-  m_filt_res.reserve(ntuples);
   
   // Calculate downscaling factor for "center" of tuples (lower/upper bound) 
   // (everything will be scaled to [0, ..., scale_fct-1])
@@ -366,7 +385,7 @@ bool scalagon::init(const std::vector<int>& v, const ppref& p, double alpha)
   for (int i = 0; i < ntuples; i++) {
     m_stuples_v[scount] = i; // v-index of scaled variable (will be overwritten if scount not incremented)
     for (int k = 0;; k++) {
-      int val = (int)floor(fct[k] * (m_prefs[k]->data[v[i]] - lower_bound[k]));
+      int val = (int)floor(fct[k] * (m_prefs[k]->value(v[i]) - lower_bound[k]));
       if (val < 0 || val >= m_scale_fct[k]) {
         m_filt_res.push_back(v[i]);
         break;
@@ -411,15 +430,13 @@ bool scalagon::init(const std::vector<int>& v, const ppref& p, double alpha)
 */
 
 // mark all dominated nodes with true in m_btg
-void scalagon::dominate(const std::vector<int>& s_ind, const ppref& p)
+void scalagon::dominate()
 {
   // Create BTG and fill with zeros
   m_btg = std::vector<bool>(m_btg_size);
   
   // Number of scaled tuples
-  
-  bool use_ind = !s_ind.empty(); // is only true if s_ind is set - just for top-k!
-  const int scount = use_ind ? s_ind.size() : m_stuples_v.size();
+  const int scount = m_stuples_v.size();
   
   // Helper variables for domination
   std::vector<int> start_dom(m_dim);
@@ -432,18 +449,14 @@ void scalagon::dominate(const std::vector<int>& s_ind, const ppref& p)
   for (int i = 0; i < scount; i++) {
     
     [&]() {
-      // Get index
-      const int cur_s_ind = use_ind ? s_ind[i] // use index (topk)
-                                    : i; // don't use index (no top k)
-      
       // ** Read tuple and preliminary checks
-      int ind = get_index_tuples(cur_s_ind); // get from stuples [0,...,scount-1]
+      int ind = get_index_tuples(i); // get from stuples [0,...,scount-1]
       if (m_btg[ind]) return; // already dominated, skip tuple
       
       // ** Search for start-domination point (left upper corner)
       int start_dom_ind = ind;
       for (int k = 0; k < m_dim; k++) {
-        start_dom[k] = m_stuples[k][cur_s_ind] + 1;
+        start_dom[k] = m_stuples[k][i] + 1;
         start_dom_ind += m_weights[k];
         if (start_dom[k] == m_scale_fct[k]) return; // outside btg - nothing to dominate!
       }
@@ -505,3 +518,69 @@ void scalagon::dominate(const std::vector<int>& s_ind, const ppref& p)
     }();
   }
 }
+
+// --------------------------------------------------------------------------------------------------------------------------------------------------------
+
+
+/*  Scalagon domination depth for top-k with
+
+* one pass over the BTG in order of the node indices
+* a lower bound of the level for each center tuple
+
+All tuples of a node c are dominated by all tuples of a node c' which is smaller in each coordinate,
+hence the level of the tuples in c is at least the depth of c, which is defined by
+
+  depth(c) = 1 + max { depth(c') | c' occupied, c' <= c - (1,...,1) }    (1 if there is no such c')
+
+The maximum over the "lower set" of c is propagated like a prefix maximum along all dimensions.
+*/
+
+// Returns the depth for each center tuple (s-index)
+std::vector<int> scalagon::dominate_depth()
+{
+  const int scount = m_stuples_v.size();
+  
+  // Mark occupied nodes
+  std::vector<bool> occupied(m_btg_size);
+  for (int i = 0; i < scount; i++) occupied[get_index_tuples(i)] = true;
+  
+  // Index offset to the diagonal predecessor c - (1,...,1)
+  int diag = 0;
+  for (int k = 0; k < m_dim; k++) diag += m_weights[k];
+  
+  // Maximal depth of all occupied nodes in the lower set (0 if there is none)
+  std::vector<int> maxdepth(m_btg_size);
+  std::vector<int> pt(m_dim); // coordinates of the current node
+  
+  for (int ind = 0; ind < m_btg_size; ind++) {
+    bool inner = true; // true if all coordinates are > 0, i.e., there is a diagonal predecessor
+    int cur_max = 0;
+    for (int k = 0; k < m_dim; k++) {
+      if (pt[k] == 0) inner = false;
+      else cur_max = std::max(cur_max, maxdepth[ind - m_weights[k]]);
+    }
+    if (occupied[ind]) cur_max = std::max(cur_max, inner ? 1 + maxdepth[ind - diag] : 1);
+    maxdepth[ind] = cur_max;
+    
+    // Increment coordinates (dimension 0 is the fastest)
+    for (int k = 0; k < m_dim; k++) {
+      if (++pt[k] < m_scale_fct[k]) break;
+      pt[k] = 0;
+    }
+  }
+  
+  // Depth of the nodes of the center tuples
+  std::vector<int> depth(scount);
+  for (int i = 0; i < scount; i++) {
+    bool inner = true;
+    for (int k = 0; k < m_dim; k++) {
+      if (m_stuples[k][i] == 0) {
+        inner = false;
+        break;
+      }
+    }
+    depth[i] = inner ? 1 + maxdepth[get_index_tuples(i) - diag] : 1;
+  }
+  
+  return depth;
+}
@@ -5,21 +5,21 @@
 
 // includes also pref-classes
 #include "bnl.h"
+#include "sfs.h"
+#include "sampler.h"
 
-// outside of Scalagon class because C++ random generator is not allowed in R
-std::vector<int> get_sample(int ntuples);
+// Sample of tuple positions for Scalagon (empty if there are not enough tuples for Scalagon)
+std::vector<int> get_sample(int ntuples, sampler& rng);
 
 class scalagon
 {
 public:
   
-  // set sample_precalc = true if NO random generator should be called from Scalagon
-  // use the sample_ind vector instead
-  scalagon(bool sample_precalc = false);
+  // The sampler is seeded from the RNG of R at the first run (main thread only!)
+  scalagon();
   
-  // sample of random numbers 
-  // (to be calculated outside from the worker thread when Scalagon is used in parallel computation)
-  std::vector<int> sample_ind;
+  // Use the given sampler, e.g., with a seed from the main thread and a stream per worker
+  explicit scalagon(const sampler& rng);
   
   // run Scalagon prefiltering together with BNL
   std::vector<int> run(const std::vector<int>& v, const ppref& p, double alpha = 10);
@@ -27,22 +27,45 @@ public:
   // Scalagon with and without top-k
   flex_vector run_topk(const std::vector<int>& v, const ppref& p, const topk_setting& ts, double alpha, bool show_levels);
   
+  // Lower bounds for the levels of the tuples in v (by the depth in the scaled lattice, 1 for outliers),
+  // empty if Scalagon is not applicable
+  std::vector<int> level_bounds(const std::vector<int>& v, const ppref& p, double alpha = 10);
+  
+  // Lattice cell of each tuple in v after level_bounds (-1 for outliers). The dominators of a tuple in a cell
+  // are outliers or tuples in cells with smaller or equal coordinates (see cell_leq)
+  std::vector<int> cells() const;
+  
+  // True if all coordinates of the cell c1 are smaller or equal to those of the cell c2
+  bool cell_leq(int c1, int c2) const;
+  
   // consts for sampling
-  static const int sample_size = 1000; // public and static to access it before class is constructed
+  static const int min_sample_size = 1000;
+  static const int max_sample_size = 10000;
   static const int scalagon_min_tuples = 10000;
   
+  // Sample size grows with the number of tuples (public and static to access it before class is constructed)
+  static int sample_size(int ntuples)
+  {
+    const int size = ntuples / 100;
+    return size < min_sample_size ? min_sample_size : (size > max_sample_size ? max_sample_size : size);
+  }
+  
 private:
   
   bnl bnl_alg;
   
-  // set by the constructor: true if sample indices will be precalculated and assigned to the public sample_ind
-  // this is important if this class is used in a parallel worker thread, where the random generator from the R API may not be called!
-  const bool sample_precalc;
+  // false if the sampler must be seeded from R before the first sample
+  // (a scalagon instance in a parallel worker thread gets a seeded sampler, as the R API may not be called there!)
+  bool m_seeded;
+  sampler m_rng;
+  
+  // Sample positions in v
+  std::vector<int> m_sample;
   
   int m_dim = 0; // Number of dimensions
   
   // All pareto / product order preferences
-  std::vector<std::shared_ptr<scorepref>> m_prefs;
+  std::vector<std::shared_ptr<leafpref>> m_prefs;
   
   // convert preferences from tree into vector
   bool get_prefs(const ppref& p);
@@ -58,8 +81,8 @@ private:
   std::vector<std::vector<int>> m_stuples;
   
   // calculate index (according to weights) of tuple
-  int get_index_pt(const std::vector<int>& pt);
-  int get_index_tuples(int ind);
+  int get_index_pt(const std::vector<int>& pt) const;
+  int get_index_tuples(int ind) const;
   
   std::vector<int> iterated_scaling(const std::vector<int>& domain_size, double btg_size);
   std::vector<int> m_scale_fct;
@@ -71,6 +94,9 @@ private:
   bool init(const std::vector<int>& v, const ppref& p, double alpha);
   
   // Domination phase, while scaling is fixed
-  void dominate(const std::vector<int>& s_ind, const ppref& p);
+  void dominate();
+  
+  // Domination phase for top-k: lower bound of the level for each center tuple (in one pass over the BTG)
+  std::vector<int> dominate_depth();
   
 };
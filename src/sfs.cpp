@@ -0,0 +1,214 @@
+#include "sfs.h"
+
+#include <limits>
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
+bool sfs::is_bounded(const topk_setting& ts)
+{
+  // Same condition as in topk_setting::cut
+  return ts.topk != -1 && (ts.and_connected || (ts.toplevel == -1 && ts.at_least == -1));
+}
+
+// Put all score preferences of a tree into a std::vector
+// Returns true if successful, false if not (found union preference)
+bool sfs::get_leaves(const ppref& p, bool reversed)
+{
+  std::shared_ptr<leafpref> spref = std::dynamic_pointer_cast<leafpref>(p);
+  if (spref != 0) {
+    m_leaves.push_back(spref);
+    m_reversed.push_back(reversed);
+    return true;
+  }
+
+  // Reverse preference: reverse of Pareto/intersection/prioritization is the same composition of the reversed leaves
+  std::shared_ptr<reversepref> rpref = std::dynamic_pointer_cast<reversepref>(p);
+  if (rpref != 0) return get_leaves(rpref->p, !reversed);
+
+  // Lexicographical order of the leaves is monotone for Pareto, intersection and prioritization
+  if (std::dynamic_pointer_cast<prior>(p) != 0) m_has_prior = true;
+  else if (std::dynamic_pointer_cast<productpref>(p) == 0) return false; // union preference
+
+  std::shared_ptr<complexpref> cpref = std::dynamic_pointer_cast<complexpref>(p);
+  return get_leaves(cpref->p1, reversed) && get_leaves(cpref->p2, reversed);
+}
+
+
+// Calculate the presorting
+//
+// * Lexicographical order of the (possibly reversed) leaves is monotone for all supported trees
+// * For Pareto/intersection trees the sum of the normalized scores is monotone too,
+//   this is used as primary key as it sorts good "dominators" to the front
+bool sfs::init(const std::vector<int>& v, const ppref& p)
+{
+  m_leaves.clear();
+  m_reversed.clear();
+  m_has_prior = false;
+  if (!get_leaves(p, false)) return false;
+
+  const int ntuples = v.size();
+  const int nleaves = m_leaves.size();
+
+  // Signed scores (reversed leaves are negated), NaN is rejected as it is incomparable
+  std::vector<std::vector<double>> vals(nleaves, std::vector<double>(ntuples));
+  for (int k = 0; k < nleaves; k++) {
+    const leafpref& leaf = *m_leaves[k];
+    for (int i = 0; i < ntuples; i++) {
+      const double val = m_reversed[k] ? -leaf.value(v[i]) : leaf.value(v[i]);
+      if (std::isnan(val)) return false;
+      vals[k][i] = val;
+    }
+  }
+
+  // Sum of normalized scores (affine transformation with positive factor is monotone)
+  std::vector<double> sums;
+  if (!m_has_prior) {
+    sums = std::vector<double>(ntuples);
+    for (int k = 0; k < nleaves; k++) {
+      const std::vector<double>& col = vals[k];
+      const auto minmax = std::minmax_element(col.begin(), col.end());
+      const double range = *minmax.second - *minmax.first;
+      if (!(range > 0 && std::isfinite(range))) continue; // constant (or infinite) dimension does not help
+      for (int i = 0; i < ntuples; i++) sums[i] += (col[i] - *minmax.first) / range;
+    }
+  }
+
+  m_order = std::vector<int>(ntuples);
+  for (int i = 0; i < ntuples; i++) m_order[i] = i;
+
+  // Stable sort: equivalent tuples keep the order of the input
+  std::stable_sort(m_order.begin(), m_order.end(), [&](int i, int j) {
+    if (!m_has_prior && sums[i] != sums[j]) return sums[i] < sums[j];
+    for (int k = 0; k < nleaves; k++) {
+      if (vals[k][i] != vals[k][j]) return vals[k][i] < vals[k][j];
+    }
+    return false;
+  });
+
+  return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
+// SFS top k with/without levels
+flex_vector sfs::run_topk(const std::vector<int>& v, const ppref& p, const topk_setting& ts, bool show_levels)
+{
+  const bool bounded = is_bounded(ts);
+
+  // One window per level. As all better tuples are read before,
+  // the level of a tuple is the first level whose window has no better tuple
+  std::vector<std::vector<int>> windows;
+  std::vector<int> level_count; // number of tuples per level
+
+  // Pairs of level and v-index
+  pair_vector res;
+
+  // All levels > max_level are not needed (do_break is true for max_level)
+  int max_level = std::numeric_limits<int>::max();
+
+  for (int i : m_order) {
+    if (interrupt::requested()) break; // result is discarded
+    const int u = v[i];
+
+    // ** Get level
+    const int nlevels = windows.size();
+    int level = 1;
+    for (; level <= nlevels; level++) {
+      bool dominated = false;
+      for (int w : windows[level - 1]) {
+        if (p->cmp(w, u)) {
+          dominated = true;
+          break;
+        }
+      }
+      if (!dominated) break;
+    }
+
+    // Tuple (and all tuples dominated by it) will not be in the result
+    if (level > max_level) continue;
+
+    if (level > nlevels) {
+      windows.push_back(std::vector<int>());
+      level_count.push_back(0);
+    }
+    windows[level - 1].push_back(u);
+    level_count[level - 1]++;
+    res.push_back(std::pair<int, int>(level, i));
+
+    // ** Update max_level, it can only decrease as the counts only increase
+    int ncum = 0;
+    for (int l = 1; l <= std::min(max_level, static_cast<int>(level_count.size())); l++) {
+      ncum += level_count[l - 1];
+      if (ts.do_break(l, ncum)) {
+        max_level = l;
+        break;
+      }
+    }
+
+    // ** Stop if the result is cut and level 1 is sufficient for the top-k tuples
+    if (bounded && max_level == 1 && level_count[0] >= ts.topk) break;
+  }
+
+  // Sort by level and position in v (like BNL, equivalent tuples are returned in order of the input)
+  std::sort(res.begin(), res.end());
+
+  std::vector<int> final_result_vector;
+  pair_vector final_result_pair_vector;
+
+  // Take all levels until do_break is true
+  for (const std::pair<int, int>& u : res) {
+    if (u.first > max_level) break;
+    if (show_levels) final_result_pair_vector.push_back(std::pair<int, int>(u.first, v[u.second]));
+    else             final_result_vector     .push_back(v[u.second]);
+  }
+
+  if (show_levels) ts.cut(final_result_pair_vector);
+  else             ts.cut(final_result_vector);
+
+  return flex_vector(final_result_vector, final_result_pair_vector);
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
+// Progressive SFS: Each tuple which is not dominated by the window is final
+bool sfs::run_progressive(const std::vector<int>& v, const ppref& p, int chunk_size,
+                          const std::function<bool(const std::vector<int>&)>& emit,
+                          const std::function<bool()>& proceed)
+{
+  // Number of read tuples between two calls of proceed
+  const int check_interval = 1024;
+  
+  std::vector<int> window;
+  std::vector<int> chunk;
+  chunk.reserve(chunk_size);
+  
+  int count = 0;
+  for (int i : m_order) {
+    
+    if (++count % check_interval == 0 && !proceed()) {
+      // Emit the confirmed maxima of the current chunk before stopping
+      if (!chunk.empty()) emit(chunk);
+      return false;
+    }
+    
+    const int u = v[i];
+    bool dominated = false;
+    for (int w : window) {
+      if (p->cmp(w, u)) {
+        dominated = true;
+        break;
+      }
+    }
+    if (dominated) continue;
+    
+    window.push_back(u);
+    chunk.push_back(u);
+    if (static_cast<int>(chunk.size()) == chunk_size) {
+      if (!emit(chunk)) return false;
+      chunk.clear();
+    }
+  }
+  
+  if (!chunk.empty()) emit(chunk);
+  return true;
+}
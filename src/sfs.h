@@ -0,0 +1,58 @@
+#pragma once
+
+// includes also pref-classes and topk-setting
+#include "bnl.h"
+
+#include <functional>
+
+// ----------------------------------------------------------------------------------------------------------------------------------------
+
+// Sort-Filter-Skyline (SFS) for bounded top(-level)-k selection
+//
+// The tuples are presorted by a key which is monotone w.r.t. the preference,
+// i.e., if tuple i is better than tuple j, then i is sorted before j.
+// Hence all better tuples are read before a tuple, and each tuple gets its final level
+// as soon as it is read. For top-k queries we can stop as soon as k tuples of level 1 are confirmed.
+//
+// See "Skyline with Presorting", J.Chomicki, P.Godfrey, J.Gryz, D.Liang,
+// 19th International Conference on Data Engineering (ICDE 2003), Bangalore, India,
+// 10.1109/ICDE.2003.1260846.
+
+class sfs
+{
+public:
+
+  // true if the top-k setting allows to stop before all levels are materialized
+  // (the result is cut to top-k tuples, hence a full level 1 is not needed)
+  static bool is_bounded(const topk_setting& ts);
+
+  // Returns false if the preference has no monotone presorting key
+  // (i.e., it is not composed of Pareto/intersection/prioritization/reverse over score preferences)
+  // or if there are NaN values in the scores
+  bool init(const std::vector<int>& v, const ppref& p);
+
+  // SFS top(-level)-k with/without levels, init must be called before
+  flex_vector run_topk(const std::vector<int>& v, const ppref& p, const topk_setting& ts, bool show_levels);
+  
+  // Progressive SFS (maxima only), init must be called before
+  // emit is called for each chunk of confirmed maxima and proceed is called regularly,
+  // the evaluation stops if one of them returns false. Returns true if all maxima were emitted
+  bool run_progressive(const std::vector<int>& v, const ppref& p, int chunk_size,
+                       const std::function<bool(const std::vector<int>&)>& emit,
+                       const std::function<bool()>& proceed);
+
+private:
+
+  // Leaf preferences of the tree and true if they are reversed
+  std::vector<std::shared_ptr<leafpref>> m_leaves;
+  std::vector<bool> m_reversed;
+
+  // true if the tree contains a prioritization (sum of scores is not monotone then)
+  bool m_has_prior = false;
+
+  // Presorted v-indices (i.e., indices of v, not tuple indices)
+  std::vector<int> m_order;
+
+  // convert preference tree into vector of leaves, false if not possible
+  bool get_leaves(const ppref& p, bool reversed);
+};
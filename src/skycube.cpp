@@ -0,0 +1,263 @@
+// [[Rcpp::depends(RcppParallel)]]
+#include <RcppParallel.h>
+using namespace RcppParallel;
+
+#include "skycube.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+using namespace Rcpp;
+
+skycube::skycube(const std::vector<std::vector<double>>& cols, const std::vector<int>& directions, bool compress) :
+  m_cols(cols), m_directions(directions), m_compress(compress)
+{
+  m_ntuples = cols.empty() ? 0 : cols[0].size();
+
+  m_pow3 = std::vector<int>(dim() + 1, 1);
+  for (int k = 1; k <= dim(); k++) m_pow3[k] = 3 * m_pow3[k - 1];
+  m_entries = std::vector<entry>(m_pow3[dim()]);
+
+  for (const std::vector<double>& col : cols) {
+    std::vector<double> sorted = col;
+    std::sort(sorted.begin(), sorted.end());
+    m_distinct.push_back(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+
+    std::vector<double> neg(col.size());
+    for (std::size_t i = 0; i < col.size(); i++) neg[i] = -col[i];
+    m_low.push_back(std::make_shared<scorepref>(std::vector<double>(col)));
+    m_high.push_back(std::make_shared<scorepref>(std::move(neg)));
+  }
+}
+
+bool skycube::allowed(int code) const
+{
+  if (code <= 0 || code >= m_pow3[dim()]) return false;
+  for (int k = 0; k < dim(); k++) {
+    const int d = digit(code, k);
+    if (d != 0 && !(m_directions[k] & d)) return false;
+  }
+  return true;
+}
+
+int skycube::encode(const std::vector<int>& digits) const
+{
+  int code = 0;
+  for (int k = 0; k < dim(); k++) code += digits[k] * m_pow3[k];
+  return code;
+}
+
+std::vector<int> skycube::layer(int ncols) const
+{
+  std::vector<int> res;
+  for (int code = 1; code < m_pow3[dim()]; code++) {
+    if (!allowed(code)) continue;
+    int n = 0;
+    for (int k = 0; k < dim(); k++) if (digit(code, k) != 0) n++;
+    if (n == ncols) res.push_back(code);
+  }
+  return res;
+}
+
+void skycube::compute(int code, scalagon& scal_alg, double alpha)
+{
+  // Preference of the subspace and its columns
+  ppref p;
+  std::vector<int> cols;
+  for (int k = dim() - 1; k >= 0; k--) {
+    const int d = digit(code, k);
+    if (d == 0) continue;
+    cols.push_back(k);
+    const ppref& leaf = (d == 1) ? m_low[k] : m_high[k];
+    p = p ? pareto::make(leaf, p) : leaf;
+  }
+
+  // Smallest computed parent
+  int parent = -1;
+  for (int k = 0; k < dim(); k++) {
+    if (digit(code, k) != 0) continue;
+    for (int d = 1; d <= 2; d++) {
+      const int pcode = code + d * m_pow3[k];
+      if (allowed(pcode) && m_entries[pcode].computed && (parent == -1 || m_entries[pcode].count < m_entries[parent].count)) {
+        parent = pcode;
+      }
+    }
+  }
+
+  std::vector<int> res;
+  if (parent == -1) {
+    std::vector<int> v(m_ntuples);
+    for (int i = 0; i < m_ntuples; i++) v[i] = i;
+    res = scal_alg.run(v, p, alpha);
+  } else {
+    std::vector<int> cand;
+    load(parent, cand);
+    res = bnl::run(cand, p);
+
+    // Tuples equal to a maximum on the subspace (impossible if a column has distinct values)
+    bool distinct = false;
+    for (int k : cols) distinct = distinct || m_distinct[k];
+    if (!distinct) {
+      auto hash = [&](int i) {
+        std::size_t h = 0;
+        for (int k : cols) h = h * 1000003 ^ std::hash<double>()(m_cols[k][i]);
+        return h;
+      };
+      auto equal = [&](int i, int j) {
+        for (int k : cols) if (m_cols[k][i] != m_cols[k][j]) return false;
+        return true;
+      };
+      std::unordered_set<int, decltype(hash), decltype(equal)> maxima(res.begin(), res.end(), res.size(), hash, equal);
+      std::vector<bool> in_res(m_ntuples);
+      for (int i : res) in_res[i] = true;
+      for (int i = 0; i < m_ntuples; i++) {
+        if (!in_res[i] && maxima.count(i) > 0) res.push_back(i);
+      }
+    }
+  }
+
+  std::sort(res.begin(), res.end());
+  store(code, res);
+}
+
+void skycube::store(int code, std::vector<int>& res)
+{
+  entry& e = m_entries[code];
+  e.count = res.size();
+  if (m_compress) {
+    int last = 0;
+    for (int i : res) {
+      uint32_t diff = i - last;
+      last = i;
+      while (diff >= 128) {
+        e.packed.push_back(static_cast<uint8_t>(diff | 128));
+        diff >>= 7;
+      }
+      e.packed.push_back(static_cast<uint8_t>(diff));
+    }
+    e.packed.shrink_to_fit();
+  } else {
+    e.plain = std::move(res);
+  }
+  e.computed = true;
+}
+
+void skycube::load(int code, std::vector<int>& res) const
+{
+  const entry& e = m_entries[code];
+  if (!m_compress) {
+    res = e.plain;
+    return;
+  }
+  res.clear();
+  res.reserve(e.count);
+  int last = 0;
+  uint32_t diff = 0;
+  int shift = 0;
+  for (uint8_t byte : e.packed) {
+    diff |= static_cast<uint32_t>(byte & 127) << shift;
+    if (byte & 128) {
+      shift += 7;
+    } else {
+      last += diff;
+      res.push_back(last);
+      diff = 0;
+      shift = 0;
+    }
+  }
+}
+
+bool skycube::get(int code, std::vector<int>& res) const
+{
+  if (!allowed(code) || !m_entries[code].computed) return false;
+  load(code, res);
+  return true;
+}
+
+int skycube::nsubspaces() const
+{
+  int res = 0;
+  for (const entry& e : m_entries) if (e.computed) res++;
+  return res;
+}
+
+double skycube::bytes() const
+{
+  double res = 0;
+  for (const entry& e : m_entries) res += e.plain.size() * sizeof(int) + e.packed.size();
+  return res;
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
+// Subspaces with the same number of columns are independent, each uses its own stream for the samples of Scalagon
+class Skycube_worker : public Worker {
+public:
+  skycube& cube;
+  const std::vector<int>& codes;
+  const double alpha;
+  const uint64_t seed;
+
+  Skycube_worker(skycube& cube, const std::vector<int>& codes, double alpha, uint64_t seed) :
+    cube(cube), codes(codes), alpha(alpha), seed(seed) {}
+
+  void operator()(std::size_t begin, std::size_t end)
+  {
+    for (std::size_t k = begin; k < end; k++) {
+      if (interrupt::requested()) return; // result is discarded
+      scalagon scal_alg(sampler(seed, codes[k]));
+      cube.compute(codes[k], scal_alg, alpha);
+    }
+  }
+};
+
+void skycube::build(double alpha, int N, uint64_t seed)
+{
+  for (int ncols = dim(); ncols >= 1; ncols--) {
+    const std::vector<int> codes = layer(ncols);
+    if (N == 1) {
+      for (int code : codes) {
+        scalagon scal_alg(sampler(seed, code));
+        compute(code, scal_alg, alpha);
+      }
+    } else {
+      Skycube_worker worker(*this, codes, alpha, seed);
+      interrupt::parallel_for(0, codes.size(), worker);
+    }
+  }
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
+// Build the skycube on the given numeric columns (without NA values) and allowed directions (1 = low, 2 = high, 3 = both)
+// [[Rcpp::export]]
+SEXP skycube_impl(const DataFrame& raw, const IntegerVector& directions, bool compress, double alpha, int N)
+{
+  std::vector<std::vector<double>> cols(raw.size());
+  for (std::size_t k = 0; k < cols.size(); k++) cols[k] = as<std::vector<double>>(as<NumericVector>(raw[k]));
+
+  XPtr<skycube> cube(new skycube(cols, as<std::vector<int>>(directions), compress), true);
+  cube->build(alpha, N, sampler::seed_from_r());
+  return cube;
+}
+
+// Skyline of a subspace (C indices), given by the digits 0 (not in subspace), 1 (low) and 2 (high) of each column
+// [[Rcpp::export]]
+NumericVector skycube_get_impl(SEXP cube, const IntegerVector& digits)
+{
+  XPtr<skycube> sc(cube);
+  if (sc.get() == 0) stop("The skycube is not available anymore, create a new one!");
+
+  std::vector<int> res;
+  if (!sc->get(sc->encode(as<std::vector<int>>(digits)), res)) stop("The subspace is not contained in the skycube!");
+  return NumericVector(res.begin(), res.end());
+}
+
+// Number of subspaces and stored bytes
+// [[Rcpp::export]]
+List skycube_info_impl(SEXP cube)
+{
+  XPtr<skycube> sc(cube);
+  if (sc.get() == 0) stop("The skycube is not available anymore, create a new one!");
+  return List::create(Named("subspaces") = sc->nsubspaces(), Named("bytes") = sc->bytes());
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+// includes also BNL and pref classes
+#include "scalagon.h"
+
+#include <cstdint>
+
+// Skycube
+// -------
+
+// Skylines of all subspaces of the given columns, where each column of a subspace is minimized or maximized.
+// A subspace is encoded in base 3, the k-th digit is 0 if column k is not in the subspace, 1 for low and 2 for high.
+// The allowed directions of each column restrict the computed subspaces (1 = low, 2 = high, 3 = both).
+//
+// The subspaces with all columns are computed from all tuples, each smaller subspace V is derived top-down
+// from its smallest parent U (V plus one column): a tuple in Sky(V) is either in Sky(U), or it is dominated in U
+// by a tuple of Sky(U) which is equal to it on V. Hence Sky(V) contains the maxima of Sky(U) w.r.t. V
+// and all tuples equal to one of them on V (only needed if no column of V has distinct values).
+
+class skycube
+{
+public:
+
+  skycube(const std::vector<std::vector<double>>& cols, const std::vector<int>& directions, bool compress);
+
+  int dim() const { return m_cols.size(); }
+
+  // Compute all subspaces (in parallel for N > 1)
+  void build(double alpha, int N, uint64_t seed);
+
+  // Skyline (ascending tuple indices) of a subspace, false if the subspace is not in the cube
+  bool get(int code, std::vector<int>& res) const;
+
+  // Encode digits (0, 1, 2 for each column) of a subspace
+  int encode(const std::vector<int>& digits) const;
+
+  // Number of subspaces and size of the stored skylines in bytes
+  int nsubspaces() const;
+  double bytes() const;
+
+  // Compute the skyline of one subspace, the parents (if any) must be computed before
+  void compute(int code, scalagon& scal_alg, double alpha);
+
+  // Subspaces with the given number of columns
+  std::vector<int> layer(int ncols) const;
+
+private:
+
+  struct entry
+  {
+    bool computed = false;
+    int count = 0;
+    std::vector<int> plain;       // ascending tuple indices (not compressed)
+    std::vector<uint8_t> packed;  // differences of the ascending tuple indices as varints (compressed)
+  };
+
+  std::vector<std::vector<double>> m_cols;
+  std::vector<int> m_directions;
+  std::vector<bool> m_distinct; // column without duplicate values?
+  const bool m_compress;
+  int m_ntuples;
+
+  std::vector<int> m_pow3;
+  std::vector<entry> m_entries; // indexed by code
+
+  // oriented leaf preferences (low and high) of each column
+  std::vector<ppref> m_low, m_high;
+
+  int digit(int code, int k) const { return (code / m_pow3[k]) % 3; }
+  bool allowed(int code) const;
+
+  void store(int code, std::vector<int>& res);
+  void load(int code, std::vector<int>& res) const;
+};
@@ -0,0 +1,104 @@
+#include "window.h"
+
+using namespace Rcpp;
+
+bool sliding_window::expired(const entry& e) const
+{
+  return m_next_seq - e.seq > m_size || e.time <= m_now - m_duration;
+}
+
+void sliding_window::push(const ppref& p, const std::vector<double>& times)
+{
+  const int nold = m_retained.size();
+  const int nnew = times.size();
+
+  for (int k = 0; k < nold; k++) m_retained[k].pos = k;
+
+  std::vector<entry> next;
+  next.reserve(nold + nnew);
+
+  for (int k = 0; k < nnew; k++) {
+    const int t = nold + k;
+    entry e = { m_next_seq, times[k], -1, t };
+    m_next_seq++;
+    m_now = times[k];
+
+    // Remove expired and dominated tuples, and find the youngest dominator of the new tuple
+    next.clear();
+    for (const entry& r : m_retained) {
+      if (expired(r) || p->cmp(t, r.pos)) continue;
+      if (p->cmp(r.pos, t)) e.dom_seq = r.seq; // retained tuples are ordered by arrival
+      next.push_back(r);
+    }
+    if (!expired(e)) next.push_back(e);
+    std::swap(m_retained, next);
+  }
+}
+
+std::vector<int> sliding_window::positions() const
+{
+  std::vector<int> res;
+  res.reserve(m_retained.size());
+  for (const entry& r : m_retained) res.push_back(r.pos);
+  return res;
+}
+
+std::vector<int> sliding_window::skyline() const
+{
+  std::vector<int> res;
+  if (m_retained.empty()) return res;
+
+  // The youngest dominator has expired if it is older than the oldest retained tuple
+  const long long first_seq = m_retained[0].seq;
+  const int n = m_retained.size();
+  for (int i = 0; i < n; i++) {
+    if (m_retained[i].dom_seq < first_seq) res.push_back(i);
+  }
+  return res;
+}
+
+std::vector<double> sliding_window::arrivals() const
+{
+  std::vector<double> res;
+  res.reserve(m_retained.size());
+  for (const entry& r : m_retained) res.push_back(r.seq);
+  return res;
+}
+
+// --------------------------------------------------------------------------------------------------------------------------------
+
+// Create a sliding window, size and duration may be Inf
+// [[Rcpp::export]]
+SEXP psel_window_impl(double size, double duration)
+{
+  return XPtr<sliding_window>(new sliding_window(size, duration), true);
+}
+
+// Add new tuples, the scores are the scores of the retained tuples (in the order of the last result)
+// followed by the new tuples. Returns the positions of the now retained tuples in the scores,
+// their arrival numbers, and which of them are maximal (C indices)
+// [[Rcpp::export]]
+List psel_window_push_impl(SEXP window, const DataFrame& scores, List serial_pref, const NumericVector& times)
+{
+  XPtr<sliding_window> win(window);
+  if (win.get() == 0) stop("The sliding window is not available anymore, create a new one!");
+
+  const int nnew = times.size();
+  for (int k = 0; k < nnew; k++) {
+    if (std::isnan(times[k]) || times[k] < (k > 0 ? times[k - 1] : win->now())) {
+      stop("The times must be non-decreasing and must not be before the times of the previous tuples.");
+    }
+  }
+
+  // De-Serialize preference
+  const ppref p = CreatePreference(serial_pref, scores);
+
+  win->push(p, std::vector<double>(times.begin(), times.end()));
+
+  const std::vector<int> pos = win->positions();
+  const std::vector<double> arr = win->arrivals();
+  const std::vector<int> sky = win->skyline();
+  return List::create(Named("positions") = NumericVector(pos.begin(), pos.end()),
+                      Named("arrivals") = NumericVector(arr.begin(), arr.end()),
+                      Named("skyline") = NumericVector(sky.begin(), sky.end()));
+}
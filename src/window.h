@@ -0,0 +1,59 @@
+#pragma once
+
+#include "pref-classes.h"
+
+// Sliding window Skyline
+// ----------------------
+
+// Skyline of the last "size" tuples or of the tuples of the last "duration" time units of a stream.
+// See "Stabbing the Sky: Efficient Skyline Computation over Sliding Windows", X. Lin, Y. Yuan, W. Wang, H. Lu, ICDE 2005.
+//
+// A tuple dominated by a younger tuple can never become maximal, as the younger tuple expires later.
+// Hence only the tuples not dominated by younger ones are retained. A retained tuple is maximal as soon as
+// its youngest (older) dominator has expired; dominators never leave the window otherwise, because a tuple
+// removing the dominator is a younger dominator itself. Each arrival is compared once with the retained tuples.
+
+class sliding_window
+{
+public:
+
+  // size and/or duration may be infinite
+  sliding_window(double size, double duration) : m_size(size), m_duration(duration) {}
+
+  // The preference p is defined on the retained tuples (positions 0, ..., nretained() - 1, in the order of arrival)
+  // followed by the new tuples with the given (non-decreasing) times
+  void push(const ppref& p, const std::vector<double>& times);
+
+  int nretained() const { return m_retained.size(); }
+
+  // Positions of the retained tuples in the preference of the last push, afterwards they are numbered 0, 1, ...
+  std::vector<int> positions() const;
+
+  // Retained tuples (0, 1, ...) which are maximal
+  std::vector<int> skyline() const;
+
+  // Arrival numbers (0, 1, ...) of the retained tuples
+  std::vector<double> arrivals() const;
+
+  // Time of the latest arrival
+  double now() const { return m_now; }
+
+private:
+
+  struct entry
+  {
+    long long seq;     // arrival number
+    double time;
+    long long dom_seq; // arrival number of the youngest dominator when the tuple arrived, -1 if there is none
+    int pos;           // position in the preference
+  };
+
+  const double m_size;
+  const double m_duration;
+
+  std::vector<entry> m_retained; // ordered by arrival
+  long long m_next_seq = 0;
+  double m_now = -INFINITY;
+
+  bool expired(const entry& e) const;
+};